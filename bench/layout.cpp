@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "trees.hpp"
+
+namespace
+{
+    using Bench::Generator;
+    using Bench::Layout;
+    using Bench::Node;
+
+    void visit(Node node, float& sum)
+    {
+        for (auto child : node.getChildren())
+        {
+            sum += child.getLayoutWidth();
+            visit(child, sum);
+        }
+    }
+
+    void BM_Create(benchmark::State& state, const Generator generate)
+    {
+        const auto count = static_cast<size_t>(state.range(0));
+        for (auto _ : state)
+        {
+            auto layout = std::make_unique<Layout>();
+            benchmark::DoNotOptimize(generate(*layout, count));
+
+            state.PauseTiming();
+            layout.reset();
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BM_Destroy(benchmark::State& state, const Generator generate)
+    {
+        const auto count = static_cast<size_t>(state.range(0));
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            auto layout = std::make_unique<Layout>();
+            generate(*layout, count);
+            state.ResumeTiming();
+
+            layout.reset();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Alternating the root width changes the width of every node in these trees, so no cached layout can be
+    // reused and each iteration visits the whole tree. Yoga may still answer some measure calls from its
+    // measurement cache when a text run fits either width.
+    void BM_CalculateLayout(benchmark::State& state, const Generator generate)
+    {
+        Layout layout;
+        Node root = generate(layout, static_cast<size_t>(state.range(0)));
+        bool wide = false;
+        for (auto _ : state)
+        {
+            wide = !wide;
+            root.setWidth(wide ? 1000.f : 999.f);
+            root.calculateLayout(YGUndefined, YGUndefined);
+            benchmark::DoNotOptimize(root.getLayoutHeight());
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // A single leaf changes size; Yoga relayouts its ancestors and reuses everything else.
+    void BM_IncrementalRelayout(benchmark::State& state, const Generator generate)
+    {
+        Layout layout;
+        Node root = generate(layout, static_cast<size_t>(state.range(0)));
+        root.calculateLayout(YGUndefined, YGUndefined);
+        Node leaf = Bench::lastLeaf(root);
+        bool tall = false;
+        for (auto _ : state)
+        {
+            tall = !tall;
+            leaf.setMinHeight(tall ? 30.f : 10.f);
+            root.calculateLayout(YGUndefined, YGUndefined);
+            benchmark::DoNotOptimize(root.getLayoutHeight());
+        }
+    }
+
+    void BM_ChildIteration(benchmark::State& state, const Generator generate)
+    {
+        Layout layout;
+        Node root = generate(layout, static_cast<size_t>(state.range(0)));
+        root.calculateLayout(YGUndefined, YGUndefined);
+        for (auto _ : state)
+        {
+            float sum = 0.f;
+            visit(root, sum);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+#define YOGACPP_BENCH_SHAPES(benchmark_fn)                                                                        \
+    BENCHMARK_CAPTURE(benchmark_fn, deep_chain, &Bench::deepChain)->Arg(64)->Arg(512);                            \
+    BENCHMARK_CAPTURE(benchmark_fn, wide_list, &Bench::wideList)->Arg(1 << 10)->Arg(1 << 14);                     \
+    BENCHMARK_CAPTURE(benchmark_fn, wrap_grid, &Bench::wrapGrid)->Arg(1 << 10)->Arg(1 << 14);                     \
+    BENCHMARK_CAPTURE(benchmark_fn, text_heavy, &Bench::textHeavy)->Arg(1 << 10)->Arg(1 << 14)
+
+    YOGACPP_BENCH_SHAPES(BM_Create);
+    YOGACPP_BENCH_SHAPES(BM_Destroy);
+    YOGACPP_BENCH_SHAPES(BM_CalculateLayout);
+    YOGACPP_BENCH_SHAPES(BM_IncrementalRelayout);
+    YOGACPP_BENCH_SHAPES(BM_ChildIteration);
+
+#undef YOGACPP_BENCH_SHAPES
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,327 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "trees.hpp"
+
+namespace
+{
+    using Bench::Context;
+    using Bench::Layout;
+    using Bench::Node;
+
+    // Every operation runs the same Yoga calls twice: through Node<Ctx>, and directly on YGNodeRef. Storage that
+    // outlives the loop on one side (the Layout, a reserved context vector) does so on the other as well.
+
+    void Create_wrapper(benchmark::State& state)
+    {
+        const auto count = static_cast<size_t>(state.range(0));
+        std::vector<Node> nodes(count);
+        Layout layout;
+        for (auto _ : state)
+        {
+            for (auto& node : nodes)
+            {
+                node = layout.createNode(1.f);
+            }
+            for (auto& node : nodes)
+            {
+                layout.destroyNode(node);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Create_raw(benchmark::State& state)
+    {
+        const auto count = static_cast<size_t>(state.range(0));
+        std::vector<YGNodeRef> nodes(count);
+        std::vector<Context> contexts;
+        contexts.reserve(count);
+        for (auto _ : state)
+        {
+            for (auto& node : nodes)
+            {
+                node = YGNodeNew();
+                YGNodeSetContext(node, &contexts.emplace_back(1.f));
+            }
+            for (auto node : nodes)
+            {
+                YGNodeFree(node);
+            }
+            contexts.clear();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BuildList_wrapper(benchmark::State& state)
+    {
+        const auto count = static_cast<size_t>(state.range(0));
+        Layout layout;
+        for (auto _ : state)
+        {
+            Node root = layout.createNode();
+            for (size_t i = 0; i < count; ++i)
+            {
+                root.createChild();
+            }
+            benchmark::DoNotOptimize(root.getChildCount());
+
+            // Frees every Yoga node but keeps the layout's slots and context storage, like the raw vectors.
+            layout.clear(Yoga::KeepCapacity::No);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void BuildList_raw(benchmark::State& state)
+    {
+        const auto count = static_cast<size_t>(state.range(0));
+        std::vector<Context> contexts;
+        contexts.reserve(count + 1);
+        std::vector<YGNodeRef> nodes;
+        nodes.reserve(count + 1);
+        for (auto _ : state)
+        {
+            YGNodeRef root = nodes.emplace_back(YGNodeNew());
+            YGNodeSetContext(root, &contexts.emplace_back());
+            for (size_t i = 0; i < count; ++i)
+            {
+                YGNodeRef child = nodes.emplace_back(YGNodeNew());
+                YGNodeSetContext(child, &contexts.emplace_back());
+                YGNodeInsertChild(root, child, YGNodeGetChildCount(root));
+            }
+            benchmark::DoNotOptimize(YGNodeGetChildCount(root));
+
+            // Freed one by one in creation order, as Layout does.
+            for (auto node : nodes)
+            {
+                YGNodeFree(node);
+            }
+            nodes.clear();
+            contexts.clear();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void SetStyle_wrapper(benchmark::State& state)
+    {
+        Layout layout;
+        const auto nodes = layout.createNodes(static_cast<size_t>(state.range(0)));
+        float value = 0.f;
+        for (auto _ : state)
+        {
+            value += 1.f;
+            for (auto node : nodes)
+            {
+                node.setWidth(value);
+                node.setHeight(value);
+                node.setMargin(YGEdgeAll, value);
+                node.setFlexGrow(1.f);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void SetStyle_raw(benchmark::State& state)
+    {
+        std::vector<YGNodeRef> nodes(static_cast<size_t>(state.range(0)));
+        for (auto& node : nodes)
+        {
+            node = YGNodeNew();
+        }
+        float value = 0.f;
+        for (auto _ : state)
+        {
+            value += 1.f;
+            for (auto node : nodes)
+            {
+                YGNodeStyleSetWidth(node, value);
+                YGNodeStyleSetHeight(node, value);
+                YGNodeStyleSetMargin(node, YGEdgeAll, value);
+                YGNodeStyleSetFlexGrow(node, 1.f);
+            }
+        }
+        for (auto node : nodes)
+        {
+            YGNodeFree(node);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void ReadLayout_wrapper(benchmark::State& state)
+    {
+        Layout layout;
+        Node root = Bench::wideList(layout, static_cast<size_t>(state.range(0)));
+        root.calculateLayout(YGUndefined, YGUndefined);
+        const auto children = root.getChildCount();
+        for (auto _ : state)
+        {
+            float sum = 0.f;
+            for (size_t i = 0; i < children; ++i)
+            {
+                const Node child = root.getChild(i);
+                sum += child.getLayoutLeft() + child.getLayoutTop() + child.getLayoutWidth() + child.getLayoutHeight();
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void ReadLayout_raw(benchmark::State& state)
+    {
+        Layout layout;
+        const YGNodeRef root = Bench::wideList(layout, static_cast<size_t>(state.range(0))).get();
+        YGNodeCalculateLayout(root, YGUndefined, YGUndefined, YGDirectionLTR);
+        const auto children = YGNodeGetChildCount(root);
+        for (auto _ : state)
+        {
+            float sum = 0.f;
+            for (size_t i = 0; i < children; ++i)
+            {
+                const YGNodeConstRef child = YGNodeGetChild(root, i);
+                sum += YGNodeLayoutGetLeft(child) + YGNodeLayoutGetTop(child) + YGNodeLayoutGetWidth(child) +
+                       YGNodeLayoutGetHeight(child);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void IterateChildren_wrapper(benchmark::State& state)
+    {
+        Layout layout;
+        Node root = Bench::wideList(layout, static_cast<size_t>(state.range(0)));
+        for (auto _ : state)
+        {
+            float sum = 0.f;
+            for (auto child : root.getChildren())
+            {
+                sum += child.getContext().textWidth;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void IterateChildren_raw(benchmark::State& state)
+    {
+        // Same shape as Bench::wideList, with each context stored in a plain array the way C API users do.
+        const auto count = static_cast<size_t>(state.range(0));
+        std::vector<Context> contexts(count);
+        const YGNodeRef root = YGNodeNew();
+        YGNodeSetContext(root, &contexts[0]);
+        YGNodeStyleSetWidth(root, 1000.f);
+        for (size_t i = 1; i < count; ++i)
+        {
+            const YGNodeRef row = YGNodeNew();
+            YGNodeSetContext(row, &contexts[i]);
+            YGNodeStyleSetHeight(row, 20.f);
+            YGNodeStyleSetMargin(row, YGEdgeBottom, 2.f);
+            YGNodeInsertChild(root, row, i - 1);
+        }
+
+        for (auto _ : state)
+        {
+            float sum = 0.f;
+            const auto children = YGNodeGetChildCount(root);
+            for (size_t i = 0; i < children; ++i)
+            {
+                sum += static_cast<const Context*>(YGNodeGetContext(YGNodeGetChild(root, i)))->textWidth;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        YGNodeFreeRecursive(root);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+#define YOGACPP_OVERHEAD_BENCH(operation)                                                                         \
+    BENCHMARK(operation##_raw)->Name(#operation "/raw")->Arg(1 << 12);                                           \
+    BENCHMARK(operation##_wrapper)->Name(#operation "/wrapper")->Arg(1 << 12)
+
+    YOGACPP_OVERHEAD_BENCH(Create);
+    YOGACPP_OVERHEAD_BENCH(BuildList);
+    YOGACPP_OVERHEAD_BENCH(SetStyle);
+    YOGACPP_OVERHEAD_BENCH(ReadLayout);
+    YOGACPP_OVERHEAD_BENCH(IterateChildren);
+
+#undef YOGACPP_OVERHEAD_BENCH
+
+    /**
+     * Console output followed by a table of wrapper cost over the raw C API, per node and operation.
+     */
+    class OverheadReporter : public benchmark::ConsoleReporter
+    {
+    public:
+        void ReportRuns(const std::vector<Run>& runs) override
+        {
+            ConsoleReporter::ReportRuns(runs);
+            for (const auto& run : runs)
+            {
+                if (run.run_type != Run::RT_Iteration)
+                {
+                    continue;
+                }
+
+                // Names look like "Operation/variant/size".
+                const auto name = run.benchmark_name();
+                const auto first = name.find('/');
+                const auto second = name.find('/', first + 1);
+                if (first == std::string::npos || second == std::string::npos)
+                {
+                    continue;
+                }
+
+                const auto items = run.counters.find("items_per_second");
+                if (items == run.counters.end() || items->second.value <= 0.0)
+                {
+                    continue;
+                }
+                const double nanosPerItem = 1e9 / items->second.value;
+                auto& timing = _timings[name.substr(0, first) + name.substr(second)];
+                (name.compare(first + 1, second - first - 1, "raw") == 0 ? timing.raw : timing.wrapper) =
+                    nanosPerItem;
+            }
+        }
+
+        void Finalize() override
+        {
+            ConsoleReporter::Finalize();
+            std::printf("\n%-28s %12s %12s %12s %9s\n", "Operation", "raw ns/node", "wrapper", "delta", "ratio");
+            for (const auto& [operation, timing] : _timings)
+            {
+                if (timing.raw <= 0.0 || timing.wrapper <= 0.0)
+                {
+                    continue;
+                }
+                std::printf("%-28s %12.2f %12.2f %+12.2f %8.2fx\n", operation.c_str(), timing.raw, timing.wrapper,
+                            timing.wrapper - timing.raw, timing.wrapper / timing.raw);
+            }
+        }
+
+    private:
+        struct Timing
+        {
+            double raw = 0.0;
+            double wrapper = 0.0;
+        };
+
+        std::map<std::string, Timing> _timings;
+    };
+} // namespace
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    OverheadReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+    return 0;
+}
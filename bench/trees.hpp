@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "yoga-cpp/yoga.hpp"
+
+namespace Bench
+{
+    /**
+     * Context used by every benchmark tree. Leaves with text behave like a single run of fixed-width glyphs.
+     */
+    struct Context
+    {
+        float textWidth = 0.f;
+
+        Context() = default;
+        explicit Context(const float textWidth) : textWidth{textWidth} {}
+
+        YGSize measure(const float width, const YGMeasureMode widthMode, float, YGMeasureMode) const
+        {
+            constexpr float lineHeight = 16.f;
+            if (widthMode == YGMeasureModeUndefined || width >= textWidth)
+            {
+                return {textWidth, lineHeight};
+            }
+
+            const float available = std::max(width, 1.f);
+            return {available, std::ceil(textWidth / available) * lineHeight};
+        }
+    };
+
+    using Layout = Yoga::Layout<Context>;
+    using Node = Yoga::Node<Context>;
+
+    // Every generator builds a tree of about count nodes and returns its root.
+    using Generator = Node (*)(Layout&, size_t);
+
+    /**
+     * A single chain of nested nodes, each with padding, count levels deep.
+     */
+    inline Node deepChain(Layout& layout, const size_t count)
+    {
+        Node root = layout.createNode();
+        root.setWidth(1000.f);
+        Node parent = root;
+        for (size_t i = 1; i < count; ++i)
+        {
+            Node child = parent.createChild();
+            child.setPadding(YGEdgeAll, 1.f);
+            child.setMinHeight(10.f);
+            parent = child;
+        }
+        return root;
+    }
+
+    /**
+     * One column with count - 1 fixed-height rows, like a long list view.
+     */
+    inline Node wideList(Layout& layout, const size_t count)
+    {
+        Node root = layout.createNode();
+        root.setWidth(1000.f);
+        for (size_t i = 1; i < count; ++i)
+        {
+            Node row = root.createChild();
+            row.setHeight(20.f);
+            row.setMargin(YGEdgeBottom, 2.f);
+        }
+        return root;
+    }
+
+    /**
+     * Wrapping sections of 16 wrapping cells each, so wrap is resolved at two levels. Sections are sized as a
+     * percentage of the root, so every cell follows the root width.
+     */
+    inline Node wrapGrid(Layout& layout, const size_t count)
+    {
+        constexpr size_t cellsPerSection = 16;
+
+        Node root = layout.createNode();
+        root.setWidth(1000.f);
+        root.setFlexDirection(YGFlexDirectionRow);
+        root.setFlexWrap(YGWrapWrap);
+        for (size_t created = 1; created < count; created += cellsPerSection + 1)
+        {
+            Node section = root.createChild();
+            section.setWidthPercent(18.f);
+            section.setFlexDirection(YGFlexDirectionRow);
+            section.setFlexWrap(YGWrapWrap);
+            section.setPadding(YGEdgeAll, 4.f);
+            for (size_t i = 0; i < cellsPerSection; ++i)
+            {
+                Node cell = section.createChild();
+                cell.setWidth(40.f);
+                cell.setHeight(40.f);
+                cell.setMargin(YGEdgeAll, 2.f);
+                cell.setFlexGrow(1.f);
+            }
+        }
+        return root;
+    }
+
+    /**
+     * Paragraphs of eight measured text runs each, laid out in wrapping rows.
+     */
+    inline Node textHeavy(Layout& layout, const size_t count)
+    {
+        constexpr size_t runsPerParagraph = 8;
+
+        Node root = layout.createNode();
+        root.setWidth(800.f);
+        for (size_t created = 1; created < count; created += runsPerParagraph + 1)
+        {
+            Node paragraph = root.createChild();
+            paragraph.setFlexDirection(YGFlexDirectionRow);
+            paragraph.setFlexWrap(YGWrapWrap);
+            paragraph.setMargin(YGEdgeBottom, 8.f);
+            for (size_t i = 0; i < runsPerParagraph; ++i)
+            {
+                Node run = paragraph.createChild(static_cast<float>(40 + (created + i) * 37 % 400));
+                run.setMeasureFunc();
+                run.setFlexShrink(1.f);
+            }
+        }
+        return root;
+    }
+
+    /**
+     * @return The last node in pre-order, a leaf deep in the tree for every generator
+     */
+    inline Node lastLeaf(Node node)
+    {
+        while (node.getChildCount() > 0)
+        {
+            node = node.getChild(node.getChildCount() - 1);
+        }
+        return node;
+    }
+} // namespace Bench
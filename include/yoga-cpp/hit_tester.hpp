@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "yoga-cpp/snapshot.hpp"
+#include "yoga-cpp/yoga.hpp"
+
+namespace Yoga
+{
+    /**
+     * Finds the last of count rectangles that contains the point; left and top edges are inclusive.
+     *
+     * Defined in src/hit_tester.cpp, which picks an AVX, SSE2 or scalar kernel once at run time, so callers
+     * built with different instruction set flags all share one definition.
+     *
+     * @param count Number of rectangles; a multiple of HitTester::lanes
+     * @return Index of that rectangle, or count if none contains the point
+     */
+    size_t findLastContaining(const float* left, const float* top, const float* right, const float* bottom,
+                              size_t count, float x, float y) noexcept;
+
+    /**
+     * Point-in-rectangle queries over a LayoutSnapshot.
+     *
+     * build() copies the absolute bounds of every captured node into edge arrays; hit tests then compare the
+     * point against several rectangles per instruction (AVX when the CPU has it, SSE2 on any other x86-64 CPU,
+     * scalar elsewhere) starting from the end of the snapshot. Snapshots are in pre-order, i.e.
+     * paint order, so the first match found is the topmost node.
+     *
+     * Children are not clipped to their parents; a child that overflows its parent is hit outside the parent's
+     * bounds, as Yoga lays it out.
+     */
+    template <typename Ctx>
+    class HitTester
+    {
+    public:
+        using node_type = Node<Ctx>;
+
+        static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+        // Rectangles are padded to a multiple of the widest kernel's step, whichever kernel runs.
+        static constexpr size_t lanes = 8;
+
+        HitTester() = default;
+
+        explicit HitTester(const LayoutSnapshot<Ctx>& snapshot) { build(snapshot); }
+
+        /**
+         * Replaces the tested rectangles with the bounds captured in snapshot.
+         *
+         * Buffers keep their capacity, so rebuilding after every layout does not allocate in steady state.
+         */
+        void build(const LayoutSnapshot<Ctx>& snapshot)
+        {
+            const auto count = snapshot.size();
+            // Pad to a whole number of steps with rectangles no point can be inside.
+            const auto padded = (count + lanes - 1) / lanes * lanes;
+            constexpr auto inf = std::numeric_limits<float>::infinity();
+
+            _nodes.assign(snapshot.nodes().begin(), snapshot.nodes().end());
+            _left.assign(padded, inf);
+            _top.assign(padded, inf);
+            _right.assign(padded, -inf);
+            _bottom.assign(padded, -inf);
+            for (size_t i = 0; i < count; ++i)
+            {
+                _left[i] = snapshot.x()[i];
+                _top[i] = snapshot.y()[i];
+                _right[i] = snapshot.x()[i] + snapshot.width()[i];
+                _bottom[i] = snapshot.y()[i] + snapshot.height()[i];
+            }
+        }
+
+        /**
+         * @return Snapshot index of the topmost node containing the point, or npos if none does
+         */
+        [[nodiscard]] size_t hitIndex(const float x, const float y) const noexcept
+        {
+            const auto count = _left.size();
+            const auto index =
+                findLastContaining(_left.data(), _top.data(), _right.data(), _bottom.data(), count, x, y);
+            return index == count ? npos : index;
+        }
+
+        /**
+         * @return The topmost node containing the point, or an invalid handle if none does
+         */
+        [[nodiscard]] node_type hitTest(const float x, const float y) const noexcept
+        {
+            const auto index = hitIndex(x, y);
+            return index == npos ? node_type{} : _nodes[index];
+        }
+
+        /**
+         * @return Number of rectangles being tested
+         */
+        [[nodiscard]] size_t size() const noexcept { return _nodes.size(); }
+
+    private:
+        std::vector<node_type> _nodes;
+        std::vector<float> _left;
+        std::vector<float> _top;
+        std::vector<float> _right;
+        std::vector<float> _bottom;
+    };
+} // namespace Yoga
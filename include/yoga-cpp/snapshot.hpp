@@ -0,0 +1,204 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "yoga-cpp/yoga.hpp"
+
+namespace Yoga
+{
+    /**
+     * Flat copy of a laid out tree in absolute coordinates, stored as structure-of-arrays.
+     *
+     * capture() visits the tree once in pre-order and writes each node's absolute position and size into
+     * parallel float arrays, ready to be uploaded to a renderer or scanned by a hit tester without calling back
+     * into Yoga. Pre-order means a node always comes after its ancestors and before anything drawn on top of it.
+     *
+     * Buffers keep their capacity between captures, so re-capturing a tree of similar size does not allocate.
+     */
+    template <typename Ctx>
+    class LayoutSnapshot
+    {
+    public:
+        using node_type = Node<Ctx>;
+
+        static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+        struct Options
+        {
+            // Also record the resolved margin, border and padding of every node.
+            bool margin = false;
+            bool border = false;
+            bool padding = false;
+            // Leave out nodes with YGDisplayNone together with their subtrees.
+            bool skipHidden = true;
+        };
+
+        // Per-edge arrays, indexed by YGEdgeLeft, YGEdgeTop, YGEdgeRight and YGEdgeBottom.
+        using EdgeArrays = std::array<std::vector<float>, 4>;
+
+        /**
+         * Replaces the snapshot contents with the current layout of root's subtree.
+         * @param root Node to capture; its own position is taken relative to its parent
+         * @param options Which optional arrays to fill
+         */
+        void capture(const node_type& root, const Options& options = {})
+        {
+            assert(root.valid() && "Node handle is invalid");
+            clear();
+            _options = options;
+
+            _stack.push_back({root, npos, 0.f, 0.f});
+            while (!_stack.empty())
+            {
+                const auto [node, parent, parentX, parentY] = _stack.back();
+                _stack.pop_back();
+                if (options.skipHidden && node.getDisplay() == YGDisplayNone)
+                {
+                    continue;
+                }
+
+                const auto index = static_cast<uint32_t>(_nodes.size());
+                const float nodeX = parentX + node.getLayoutLeft();
+                const float nodeY = parentY + node.getLayoutTop();
+                _nodes.push_back(node);
+                _parents.push_back(parent);
+                _x.push_back(nodeX);
+                _y.push_back(nodeY);
+                _width.push_back(node.getLayoutWidth());
+                _height.push_back(node.getLayoutHeight());
+                if (options.margin)
+                {
+                    appendEdges(_margin, [&](const YGEdge edge) { return node.getLayoutMargin(edge); });
+                }
+                if (options.border)
+                {
+                    appendEdges(_border, [&](const YGEdge edge) { return node.getLayoutBorder(edge); });
+                }
+                if (options.padding)
+                {
+                    appendEdges(_padding, [&](const YGEdge edge) { return node.getLayoutPadding(edge); });
+                }
+
+                for (auto i = node.getChildCount(); i > 0; --i)
+                {
+                    _stack.push_back({node.getChild(i - 1), index, nodeX, nodeY});
+                }
+            }
+        }
+
+        /**
+         * Empties the snapshot while keeping its buffers allocated.
+         */
+        void clear() noexcept
+        {
+            _nodes.clear();
+            _parents.clear();
+            _x.clear();
+            _y.clear();
+            _width.clear();
+            _height.clear();
+            for (auto* edges : {&_margin, &_border, &_padding})
+            {
+                for (auto& edge : *edges)
+                {
+                    edge.clear();
+                }
+            }
+        }
+
+        /**
+         * @return Number of captured nodes
+         */
+        [[nodiscard]] size_t size() const noexcept { return _nodes.size(); }
+
+        /**
+         * @return Whether no nodes are captured
+         */
+        [[nodiscard]] bool empty() const noexcept { return _nodes.empty(); }
+
+        /**
+         * @return Options used by the last capture
+         */
+        [[nodiscard]] const Options& getOptions() const noexcept { return _options; }
+
+        /**
+         * @return Captured node handles in pre-order
+         */
+        [[nodiscard]] std::span<const node_type> nodes() const noexcept { return _nodes; }
+
+        /**
+         * @return Snapshot index of each node's parent, or npos for the captured root
+         */
+        [[nodiscard]] std::span<const uint32_t> parents() const noexcept { return _parents; }
+
+        /**
+         * @return Absolute left edge of each node
+         */
+        [[nodiscard]] std::span<const float> x() const noexcept { return _x; }
+
+        /**
+         * @return Absolute top edge of each node
+         */
+        [[nodiscard]] std::span<const float> y() const noexcept { return _y; }
+
+        /**
+         * @return Laid out width of each node
+         */
+        [[nodiscard]] std::span<const float> width() const noexcept { return _width; }
+
+        /**
+         * @return Laid out height of each node
+         */
+        [[nodiscard]] std::span<const float> height() const noexcept { return _height; }
+
+        /**
+         * @return Resolved margins per edge; empty unless Options::margin was set
+         */
+        [[nodiscard]] const EdgeArrays& margin() const noexcept { return _margin; }
+
+        /**
+         * @return Resolved border widths per edge; empty unless Options::border was set
+         */
+        [[nodiscard]] const EdgeArrays& border() const noexcept { return _border; }
+
+        /**
+         * @return Resolved padding per edge; empty unless Options::padding was set
+         */
+        [[nodiscard]] const EdgeArrays& padding() const noexcept { return _padding; }
+
+    private:
+        struct Pending
+        {
+            node_type node;
+            uint32_t parent;
+            float parentX;
+            float parentY;
+        };
+
+        template <typename Fn>
+        static void appendEdges(EdgeArrays& edges, Fn&& read)
+        {
+            edges[0].push_back(read(YGEdgeLeft));
+            edges[1].push_back(read(YGEdgeTop));
+            edges[2].push_back(read(YGEdgeRight));
+            edges[3].push_back(read(YGEdgeBottom));
+        }
+
+        Options _options;
+        std::vector<node_type> _nodes;
+        std::vector<uint32_t> _parents;
+        std::vector<float> _x;
+        std::vector<float> _y;
+        std::vector<float> _width;
+        std::vector<float> _height;
+        EdgeArrays _margin;
+        EdgeArrays _border;
+        EdgeArrays _padding;
+        std::vector<Pending> _stack;
+    };
+} // namespace Yoga
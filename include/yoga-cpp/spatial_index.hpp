@@ -0,0 +1,476 @@
+#pragma once
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "yoga-cpp/yoga.hpp"
+
+namespace Yoga
+{
+    /**
+     * Uniform grid over the absolute bounds of laid out nodes, for region and point queries.
+     *
+     * Every node is bucketed into the grid cells its rectangle overlaps, so a query only looks at the nodes
+     * sharing a cell with the query region instead of walking the tree. update() refreshes the grid after a
+     * layout pass by following Yoga's hasNewLayout flags: unflagged branches are skipped, except below a node
+     * whose absolute origin moved, since its whole subtree moved with it.
+     *
+     * Nodes covering more than maxCellsPerEntry cells, such as the container of a long scrolling list, and nodes
+     * with non-finite bounds are kept in a separate list that every query checks instead of in the grid. Query
+     * ranges are clipped to the occupied part of the grid, and a query covering more cells than are occupied
+     * scans the occupied cells instead, so neither huge nodes nor huge queries cost more than the index holds.
+     *
+     * The index holds node handles, not ownership. Nodes that are detached from the indexed tree stay indexed
+     * until remove() is called for them; destroyed nodes are skipped by queries and dropped by prune().
+     */
+    template <typename Ctx>
+    class SpatialIndex
+    {
+    public:
+        using node_type = Node<Ctx>;
+
+        // Entries spanning more grid cells than this are kept out of the grid.
+        static constexpr int64_t maxCellsPerEntry = 64;
+
+        /**
+         * @param cellSize Edge length of a grid cell in layout points; roughly the size of a typical node works well
+         */
+        explicit SpatialIndex(const float cellSize = 64.f) : _cellSize{cellSize}
+        {
+            assert(cellSize > 0.f && "Cell size must be positive");
+        }
+
+        /**
+         * Brings the index up to date with the last layout of root's subtree.
+         *
+         * @param root Node the layout was calculated from; its position is taken relative to its parent
+         * @param clearFlags Whether to clear hasNewLayout on visited nodes. Pass false if another consumer,
+         * such as Layout::collectUpdated, still needs to see them.
+         */
+        void update(const node_type& root, const bool clearFlags = true) { refresh(root, false, clearFlags); }
+
+        /**
+         * Indexes every node of root's subtree regardless of hasNewLayout.
+         */
+        void rebuild(const node_type& root, const bool clearFlags = true)
+        {
+            clear();
+            refresh(root, true, clearFlags);
+        }
+
+        /**
+         * Removes a node from the index. Its descendants are left alone.
+         */
+        void remove(const node_type& node)
+        {
+            if (const auto it = _lookup.find(node.get()); it != _lookup.end() && _entries[it->second].node == node)
+            {
+                erase(it->second);
+            }
+        }
+
+        /**
+         * Drops every entry whose node has been destroyed.
+         */
+        void prune()
+        {
+            for (uint32_t id = 0; id < _entries.size(); ++id)
+            {
+                if (_entries[id].live && !_entries[id].node.valid())
+                {
+                    erase(id);
+                }
+            }
+        }
+
+        /**
+         * Empties the index.
+         */
+        void clear()
+        {
+            _entries.clear();
+            _freeIds.clear();
+            _lookup.clear();
+            _cells.clear();
+            _large.clear();
+            _occupied = {};
+            _size = 0;
+        }
+
+        /**
+         * Writes every live node whose bounds overlap the given rectangle.
+         * @return The output iterator past the last written node
+         */
+        template <typename OutputIt>
+        OutputIt query(const float x, const float y, const float width, const float height, OutputIt out)
+        {
+            return visit(x, y, x + width, y + height,
+                         [&](const Entry& entry)
+                         {
+                             return entry.x < x + width && entry.x + entry.width > x && entry.y < y + height &&
+                                    entry.y + entry.height > y;
+                         },
+                         out);
+        }
+
+        /**
+         * Writes every live node whose bounds contain the point. Left and top edges are inclusive.
+         * @return The output iterator past the last written node
+         */
+        template <typename OutputIt>
+        OutputIt queryPoint(const float x, const float y, OutputIt out)
+        {
+            return visit(x, y, x, y,
+                         [&](const Entry& entry)
+                         {
+                             return x >= entry.x && x < entry.x + entry.width && y >= entry.y &&
+                                    y < entry.y + entry.height;
+                         },
+                         out);
+        }
+
+        /**
+         * @return Number of indexed nodes
+         */
+        [[nodiscard]] size_t size() const noexcept { return _size; }
+
+        /**
+         * @return Edge length of a grid cell
+         */
+        [[nodiscard]] float getCellSize() const noexcept { return _cellSize; }
+
+    private:
+        struct Entry
+        {
+            node_type node;
+            float x = 0.f;
+            float y = 0.f;
+            float width = 0.f;
+            float height = 0.f;
+            int32_t cellLeft = 0;
+            int32_t cellTop = 0;
+            int32_t cellRight = -1;
+            int32_t cellBottom = -1;
+            uint32_t stamp = 0;
+            bool live = false;
+            bool large = false;
+        };
+
+        // Inclusive range of grid cells.
+        struct CellRange
+        {
+            int32_t left = 0;
+            int32_t top = 0;
+            int32_t right = -1;
+            int32_t bottom = -1;
+
+            [[nodiscard]] bool empty() const noexcept { return right < left || bottom < top; }
+
+            [[nodiscard]] double count() const noexcept
+            {
+                return empty() ? 0.0
+                               : (static_cast<double>(right) - left + 1.0) * (static_cast<double>(bottom) - top + 1.0);
+            }
+        };
+
+        struct Pending
+        {
+            node_type node;
+            float parentX;
+            float parentY;
+            bool moved;
+        };
+
+        void refresh(const node_type& root, const bool force, const bool clearFlags)
+        {
+            assert(root.valid() && "Node handle is invalid");
+            _stack.clear();
+            _stack.push_back({root, 0.f, 0.f, force});
+            while (!_stack.empty())
+            {
+                auto [node, parentX, parentY, moved] = _stack.back();
+                _stack.pop_back();
+                if (!moved && !node.hasNewLayout())
+                {
+                    continue;
+                }
+                if (clearFlags)
+                {
+                    node.setHasNewLayout(false);
+                }
+
+                const float x = parentX + node.getLayoutLeft();
+                const float y = parentY + node.getLayoutTop();
+                const bool originMoved = place(node, x, y, node.getLayoutWidth(), node.getLayoutHeight());
+
+                for (auto i = node.getChildCount(); i > 0; --i)
+                {
+                    _stack.push_back({node.getChild(i - 1), x, y, moved || originMoved});
+                }
+            }
+        }
+
+        // Inserts or moves the node's entry. Returns whether its absolute origin changed.
+        bool place(node_type node, const float x, const float y, const float width, const float height)
+        {
+            uint32_t id;
+            if (const auto it = _lookup.find(node.get()); it != _lookup.end() && _entries[it->second].node == node)
+            {
+                id = it->second;
+                const auto& entry = _entries[id];
+                if (entry.x == x && entry.y == y && entry.width == width && entry.height == height)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                if (it != _lookup.end())
+                {
+                    // The Yoga node address was reused by a node created after the indexed one was destroyed.
+                    erase(it->second);
+                }
+                id = allocate(node);
+            }
+
+            auto& entry = _entries[id];
+            const bool originMoved = entry.x != x || entry.y != y || (entry.cellRight < entry.cellLeft && !entry.large);
+            unlink(id);
+            entry.x = x;
+            entry.y = y;
+            entry.width = width;
+            entry.height = height;
+            link(id);
+            return originMoved;
+        }
+
+        uint32_t allocate(const node_type& node)
+        {
+            uint32_t id;
+            if (!_freeIds.empty())
+            {
+                id = _freeIds.back();
+                _freeIds.pop_back();
+                _entries[id] = Entry{};
+            }
+            else
+            {
+                id = static_cast<uint32_t>(_entries.size());
+                _entries.emplace_back();
+            }
+
+            _entries[id].node = node;
+            _entries[id].live = true;
+            _lookup[node.get()] = id;
+            ++_size;
+            return id;
+        }
+
+        void erase(const uint32_t id)
+        {
+            unlink(id);
+            auto& entry = _entries[id];
+            _lookup.erase(entry.node.get());
+            entry.live = false;
+            entry.node = node_type{};
+            _freeIds.push_back(id);
+            --_size;
+        }
+
+        // Nodes without area cannot contain anything and are kept out of the grid.
+        void link(const uint32_t id)
+        {
+            auto& entry = _entries[id];
+            entry.cellLeft = 0;
+            entry.cellRight = -1;
+            if (!(entry.width > 0.f && entry.height > 0.f))
+            {
+                return;
+            }
+
+            const CellRange cells{cellOf(entry.x), cellOf(entry.y), cellOf(entry.x + entry.width),
+                                  cellOf(entry.y + entry.height)};
+            if (!std::isfinite(entry.x + entry.width) || !std::isfinite(entry.y + entry.height) ||
+                cells.count() > static_cast<double>(maxCellsPerEntry))
+            {
+                entry.large = true;
+                _large.push_back(id);
+                return;
+            }
+
+            entry.cellLeft = cells.left;
+            entry.cellTop = cells.top;
+            entry.cellRight = cells.right;
+            entry.cellBottom = cells.bottom;
+            for (auto cy = entry.cellTop; cy <= entry.cellBottom; ++cy)
+            {
+                for (auto cx = entry.cellLeft; cx <= entry.cellRight; ++cx)
+                {
+                    _cells[key(cx, cy)].push_back(id);
+                }
+            }
+
+            if (_occupied.empty())
+            {
+                _occupied = cells;
+            }
+            else
+            {
+                _occupied.left = std::min(_occupied.left, cells.left);
+                _occupied.top = std::min(_occupied.top, cells.top);
+                _occupied.right = std::max(_occupied.right, cells.right);
+                _occupied.bottom = std::max(_occupied.bottom, cells.bottom);
+            }
+        }
+
+        void unlink(const uint32_t id)
+        {
+            auto& entry = _entries[id];
+            if (entry.large)
+            {
+                std::erase(_large, id);
+                entry.large = false;
+            }
+            for (auto cy = entry.cellTop; cy <= entry.cellBottom && entry.cellLeft <= entry.cellRight; ++cy)
+            {
+                for (auto cx = entry.cellLeft; cx <= entry.cellRight; ++cx)
+                {
+                    const auto cell = _cells.find(key(cx, cy));
+                    assert(cell != _cells.end() && "Entry missing from its grid cell");
+                    auto& ids = cell->second;
+                    for (auto& other : ids)
+                    {
+                        if (other == id)
+                        {
+                            other = ids.back();
+                            ids.pop_back();
+                            break;
+                        }
+                    }
+                    if (ids.empty())
+                    {
+                        _cells.erase(cell);
+                    }
+                }
+            }
+            entry.cellLeft = 0;
+            entry.cellRight = -1;
+        }
+
+        template <typename Predicate, typename OutputIt>
+        OutputIt visit(const float left, const float top, const float right, const float bottom,
+                       Predicate&& overlaps, OutputIt out)
+        {
+            // Stamps make sure a node spanning several cells is reported once.
+            if (++_stamp == 0)
+            {
+                for (auto& entry : _entries)
+                {
+                    entry.stamp = 0;
+                }
+                _stamp = 1;
+            }
+
+            const auto report = [&](const uint32_t id)
+            {
+                auto& entry = _entries[id];
+                if (entry.stamp == _stamp)
+                {
+                    return;
+                }
+                entry.stamp = _stamp;
+                if (entry.node.valid() && overlaps(entry))
+                {
+                    *out++ = entry.node;
+                }
+            };
+
+            for (const auto id : _large)
+            {
+                report(id);
+            }
+
+            // NaN bounds match nothing.
+            if (!(left <= right && top <= bottom))
+            {
+                return out;
+            }
+            const CellRange range{std::max(cellOf(left), _occupied.left), std::max(cellOf(top), _occupied.top),
+                                  std::min(cellOf(right), _occupied.right), std::min(cellOf(bottom), _occupied.bottom)};
+            if (range.empty())
+            {
+                return out;
+            }
+
+            if (range.count() > static_cast<double>(_cells.size()))
+            {
+                for (const auto& [cellKey, ids] : _cells)
+                {
+                    const auto cx = static_cast<int32_t>(static_cast<uint32_t>(cellKey >> 32));
+                    const auto cy = static_cast<int32_t>(static_cast<uint32_t>(cellKey));
+                    if (cx >= range.left && cx <= range.right && cy >= range.top && cy <= range.bottom)
+                    {
+                        for (const auto id : ids)
+                        {
+                            report(id);
+                        }
+                    }
+                }
+                return out;
+            }
+
+            for (auto cy = range.top; cy <= range.bottom; ++cy)
+            {
+                for (auto cx = range.left; cx <= range.right; ++cx)
+                {
+                    const auto cell = _cells.find(key(cx, cy));
+                    if (cell == _cells.end())
+                    {
+                        continue;
+                    }
+
+                    for (const auto id : cell->second)
+                    {
+                        report(id);
+                    }
+                }
+            }
+            return out;
+        }
+
+        // Coordinates beyond the grid, infinite ones included, land in its outermost cells.
+        [[nodiscard]] int32_t cellOf(const float coordinate) const noexcept
+        {
+            constexpr auto first = std::numeric_limits<int32_t>::min();
+            constexpr auto last = std::numeric_limits<int32_t>::max();
+            const double cell = std::floor(static_cast<double>(coordinate) / _cellSize);
+            if (!(cell > first))
+            {
+                return first;
+            }
+            return cell < last ? static_cast<int32_t>(cell) : last;
+        }
+
+        static uint64_t key(const int32_t cx, const int32_t cy) noexcept
+        {
+            return static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32 | static_cast<uint32_t>(cy);
+        }
+
+        float _cellSize;
+        std::vector<Entry> _entries;
+        std::vector<uint32_t> _freeIds;
+        std::unordered_map<YGNodeRef, uint32_t> _lookup;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> _cells;
+        std::vector<uint32_t> _large;
+        // Cells that have held an entry since the last clear(); only grows, so it may be wider than needed.
+        CellRange _occupied;
+        std::vector<Pending> _stack;
+        uint32_t _stamp = 0;
+        size_t _size = 0;
+    };
+} // namespace Yoga
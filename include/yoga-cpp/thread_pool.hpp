@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Yoga
+{
+    /**
+     * Fixed set of worker threads running index ranges in parallel.
+     *
+     * parallelFor() hands out indices one at a time from a shared atomic counter, so a thread that finishes a
+     * cheap item immediately takes the next one and uneven work balances itself out. The calling thread takes
+     * part in the loop instead of sleeping until the workers are done.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @param threadCount Number of threads running a loop, including the calling thread
+         */
+        explicit ThreadPool(size_t threadCount = defaultThreadCount());
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+        ThreadPool(ThreadPool&&) = delete;
+        ThreadPool& operator=(ThreadPool&&) = delete;
+
+        /**
+         * Calls fn(i) for every i in [0, count) across the pool and returns once every call has finished.
+         *
+         * Loops submitted from several threads run one after another. A loop started from inside fn runs
+         * serially on the calling thread.
+         *
+         * If fn throws, indices that have not been started are skipped and the first exception is rethrown
+         * here once every call already running has returned.
+         *
+         * @param count Number of indices
+         * @param fn Callable taking the index; called concurrently from several threads
+         */
+        template <typename Fn>
+        void parallelFor(const size_t count, Fn&& fn)
+        {
+            using Callable = std::remove_reference_t<Fn>;
+            dispatch(
+                count,
+                [](void* state, const size_t index) { (*static_cast<Callable*>(state))(index); },
+                const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+        }
+
+        /**
+         * @return Number of threads running a loop, including the calling thread
+         */
+        [[nodiscard]] size_t size() const noexcept { return _workers.size() + 1; }
+
+        /**
+         * @return The hardware concurrency, or 1 if it is unknown
+         */
+        [[nodiscard]] static size_t defaultThreadCount() noexcept;
+
+    private:
+        using Task = void (*)(void*, size_t);
+
+        void dispatch(size_t count, Task task, void* state);
+        void work() noexcept;
+        void workerLoop();
+
+        std::vector<std::thread> _workers;
+        std::mutex _submit;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        Task _task = nullptr;
+        void* _state = nullptr;
+        size_t _count = 0;
+        std::atomic<size_t> _next{0};
+        size_t _active = 0;
+        std::exception_ptr _error;
+        uint64_t _generation = 0;
+        bool _stop = false;
+    };
+} // namespace Yoga
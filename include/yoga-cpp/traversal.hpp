@@ -0,0 +1,329 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <vector>
+
+#include "yoga-cpp/yoga.hpp"
+
+namespace Yoga::views
+{
+    struct TraversalOptions
+    {
+        // Leave out nodes with YGDisplayNone together with their subtrees.
+        bool skipHidden = false;
+    };
+
+    /**
+     * Element of a traversal: a node and its depth below the traversal root, which has depth 0.
+     */
+    template <typename NodeT>
+    struct Visit
+    {
+        NodeT node;
+        uint32_t depth;
+    };
+
+    enum class TraversalOrder
+    {
+        PreOrder,
+        PostOrder,
+        BreadthFirst,
+    };
+
+    template <typename NodeT, TraversalOrder Order>
+    class TraversalView;
+
+    /**
+     * Reusable work area for traversal views.
+     *
+     * Holds the stack (or queue, for breadth-first) of pending nodes. Passing the same buffer to every
+     * traversal keeps its capacity, so walking trees of similar shape does not allocate after the first time.
+     * A buffer can only back one traversal at a time.
+     */
+    template <typename NodeT>
+    class TraversalBuffer
+    {
+    public:
+        /**
+         * Preallocates room for count pending nodes.
+         */
+        void reserve(const size_t count) { _frames.reserve(count); }
+
+        /**
+         * @return Number of pending nodes the buffer can hold without allocating
+         */
+        [[nodiscard]] size_t capacity() const noexcept { return _frames.capacity(); }
+
+    private:
+        template <typename, TraversalOrder>
+        friend class TraversalView;
+
+        struct Frame
+        {
+            NodeT node;
+            uint32_t depth;
+            // Post-order only: children of node not yet descended into.
+            ChildIterator<NodeT> next;
+            ChildIterator<NodeT> end;
+        };
+
+        std::vector<Frame> _frames;
+        // Breadth-first only: index of the node being visited.
+        size_t _head = 0;
+    };
+
+    /**
+     * Single-pass range over a subtree in the given order, driven by an explicit stack or queue instead of
+     * recursion, so depth is only limited by memory.
+     *
+     * Children are read from Yoga's child arrays as the walk reaches them. The body of a loop may change the
+     * layout and style of any node and, in pre-order and breadth-first walks, the children of the node being
+     * visited; in post-order the children of its ancestors must not change until the walk leaves them.
+     */
+    template <typename NodeT, TraversalOrder Order>
+    class TraversalView : public std::ranges::view_interface<TraversalView<NodeT, Order>>
+    {
+    public:
+        using buffer_type = TraversalBuffer<NodeT>;
+
+        class iterator
+        {
+        public:
+            using iterator_concept = std::input_iterator_tag;
+            using value_type = Visit<NodeT>;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            explicit iterator(TraversalView* view) : _view{view} {}
+
+            value_type operator*() const { return _view->_current; }
+
+            iterator& operator++()
+            {
+                _view->advance();
+                return *this;
+            }
+
+            void operator++(int) { ++*this; }
+
+            bool operator==(std::default_sentinel_t) const { return _view->_done; }
+
+        private:
+            TraversalView* _view = nullptr;
+        };
+
+        TraversalView() = default;
+
+        TraversalView(const NodeT& root, buffer_type& buffer, const TraversalOptions& options) :
+            _root{root}, _buffer{&buffer}, _options{options}
+        {
+        }
+
+        TraversalView(const NodeT& root, const TraversalOptions& options) :
+            _root{root}, _owned{std::make_unique<buffer_type>()}, _buffer{_owned.get()}, _options{options}
+        {
+        }
+
+        /**
+         * Starts the walk over from the root.
+         */
+        iterator begin()
+        {
+            assert(_buffer != nullptr && "Traversal has no buffer");
+            _buffer->_frames.clear();
+            _buffer->_head = 0;
+            _done = !_root.valid() || hidden(_root);
+            if (_done)
+            {
+                return iterator{this};
+            }
+
+            if constexpr (Order == TraversalOrder::PreOrder)
+            {
+                _current = {_root, 0};
+            }
+            else if constexpr (Order == TraversalOrder::PostOrder)
+            {
+                push(_root, 0);
+                descend();
+            }
+            else
+            {
+                push(_root, 0);
+                _current = {_root, 0};
+            }
+            return iterator{this};
+        }
+
+        std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+    private:
+        using Frame = typename buffer_type::Frame;
+
+        [[nodiscard]] bool hidden(NodeT node) const
+        {
+            return _options.skipHidden && node.getDisplay() == YGDisplayNone;
+        }
+
+        void push(NodeT node, const uint32_t depth)
+        {
+            auto children = node.getChildren();
+            _buffer->_frames.push_back(Frame{node, depth, children.begin(), children.end()});
+        }
+
+        // Post-order: walks down to the first child-less node below the top of the stack.
+        void descend()
+        {
+            auto& frames = _buffer->_frames;
+            while (true)
+            {
+                auto& top = frames.back();
+                if (top.next == top.end)
+                {
+                    break;
+                }
+
+                const NodeT child = *top.next++;
+                if (!hidden(child))
+                {
+                    push(child, top.depth + 1);
+                }
+            }
+            _current = {frames.back().node, frames.back().depth};
+        }
+
+        void advance()
+        {
+            auto& frames = _buffer->_frames;
+            if constexpr (Order == TraversalOrder::PreOrder)
+            {
+                auto children = _current.node.getChildren();
+                for (auto it = children.end(); it != children.begin();)
+                {
+                    const NodeT child = *--it;
+                    if (!hidden(child))
+                    {
+                        frames.push_back(Frame{child, _current.depth + 1, {}, {}});
+                    }
+                }
+
+                _done = frames.empty();
+                if (!_done)
+                {
+                    _current = {frames.back().node, frames.back().depth};
+                    frames.pop_back();
+                }
+            }
+            else if constexpr (Order == TraversalOrder::PostOrder)
+            {
+                frames.pop_back();
+                _done = frames.empty();
+                if (!_done)
+                {
+                    descend();
+                }
+            }
+            else
+            {
+                for (auto child : _current.node.getChildren())
+                {
+                    if (!hidden(child))
+                    {
+                        frames.push_back(Frame{child, _current.depth + 1, {}, {}});
+                    }
+                }
+
+                // Drop visited nodes once they make up most of the queue, keeping it proportional to the widest
+                // level rather than the whole tree.
+                auto& head = _buffer->_head;
+                ++head;
+                if (head >= 64 && head * 2 >= frames.size())
+                {
+                    frames.erase(frames.begin(), frames.begin() + static_cast<std::ptrdiff_t>(head));
+                    head = 0;
+                }
+
+                _done = head == frames.size();
+                if (!_done)
+                {
+                    _current = {frames[head].node, frames[head].depth};
+                }
+            }
+        }
+
+        NodeT _root;
+        std::unique_ptr<buffer_type> _owned;
+        buffer_type* _buffer = nullptr;
+        TraversalOptions _options;
+        Visit<NodeT> _current{};
+        bool _done = true;
+    };
+
+    /**
+     * Visits root and its descendants, each node before its children.
+     * @param buffer Work area to reuse; must outlive the traversal
+     */
+    template <typename NodeT>
+    TraversalView<NodeT, TraversalOrder::PreOrder> preorder(const NodeT& root, TraversalBuffer<NodeT>& buffer,
+                                                            const TraversalOptions& options = {})
+    {
+        return {root, buffer, options};
+    }
+
+    /**
+     * Visits root and its descendants, each node before its children, with a work area owned by the view.
+     */
+    template <typename NodeT>
+    TraversalView<NodeT, TraversalOrder::PreOrder> preorder(const NodeT& root, const TraversalOptions& options = {})
+    {
+        return {root, options};
+    }
+
+    /**
+     * Visits root and its descendants, each node after its children.
+     * @param buffer Work area to reuse; must outlive the traversal
+     */
+    template <typename NodeT>
+    TraversalView<NodeT, TraversalOrder::PostOrder> postorder(const NodeT& root, TraversalBuffer<NodeT>& buffer,
+                                                              const TraversalOptions& options = {})
+    {
+        return {root, buffer, options};
+    }
+
+    /**
+     * Visits root and its descendants, each node after its children, with a work area owned by the view.
+     */
+    template <typename NodeT>
+    TraversalView<NodeT, TraversalOrder::PostOrder> postorder(const NodeT& root, const TraversalOptions& options = {})
+    {
+        return {root, options};
+    }
+
+    /**
+     * Visits root and its descendants level by level, in child order within a level.
+     * @param buffer Work area to reuse; must outlive the traversal
+     */
+    template <typename NodeT>
+    TraversalView<NodeT, TraversalOrder::BreadthFirst> breadth_first(const NodeT& root,
+                                                                     TraversalBuffer<NodeT>& buffer,
+                                                                     const TraversalOptions& options = {})
+    {
+        return {root, buffer, options};
+    }
+
+    /**
+     * Visits root and its descendants level by level, with a work area owned by the view.
+     */
+    template <typename NodeT>
+    TraversalView<NodeT, TraversalOrder::BreadthFirst> breadth_first(const NodeT& root,
+                                                                     const TraversalOptions& options = {})
+    {
+        return {root, options};
+    }
+} // namespace Yoga::views
@@ -1,58 +1,72 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <ranges>
-#include <unordered_map>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 
 #include "yoga/Yoga.h"
+#include "yoga/node/Node.h"
 
 namespace Yoga
 {
+    /**
+     * Random access iterator over a node's children.
+     *
+     * Walks Yoga's own array of child pointers, so advancing is a pointer increment and dereferencing builds a
+     * handle straight from the child and its context without a call into the C API. Like an iterator into any
+     * vector, it is invalidated when children are added to or removed from the parent.
+     */
     template <typename Node>
     class ChildIterator
     {
     public:
+        using iterator_concept = std::random_access_iterator_tag;
         using iterator_category = std::random_access_iterator_tag;
         using value_type = Node;
         using difference_type = std::ptrdiff_t;
-        using pointer = Node*;
         using reference = Node;
 
-        ChildIterator() : _index{0}, _size{0} {}
+        // Handles are produced by value, so operator-> hands out a proxy that owns one.
+        class pointer
+        {
+        public:
+            explicit pointer(const Node& node) : _node{node} {}
 
-        explicit ChildIterator(const Node& parent) : _parent{parent}, _index{0}, _size{parent.getChildCount()} {}
+            Node* operator->() noexcept { return &_node; }
 
-        explicit ChildIterator(const Node& parent, const difference_type index, const size_t size) :
-            _parent{parent}, _index(index), _size(size)
-        {
-        }
+        private:
+            Node _node;
+        };
 
-        reference operator*() const
-        {
-            assert(_index >= 0 && static_cast<size_t>(_index) < _size && "Iterator out of bounds");
-            return _parent.getChild(_index);
-        }
+        ChildIterator() = default;
 
-        pointer operator->()
-        {
-            assert(_index >= 0 && static_cast<size_t>(_index) < _size && "Iterator out of bounds");
-            _proxyNode = _parent.getChild(_index);
-            return &_proxyNode;
-        }
+        explicit ChildIterator(facebook::yoga::Node* const* child) : _child{child} {}
 
-        reference operator[](const difference_type offset) const
-        {
-            const auto newIndex = _index + offset;
-            assert(newIndex >= 0 && static_cast<size_t>(newIndex) < _size && "Iterator out of bounds");
-            return _parent.getChild(newIndex);
-        }
+        reference operator*() const { return Node::fromChild(*_child); }
+
+        pointer operator->() const { return pointer{**this}; }
+
+        reference operator[](const difference_type offset) const { return Node::fromChild(_child[offset]); }
 
         ChildIterator& operator++()
         {
-            ++_index;
+            ++_child;
             return *this;
         }
 
@@ -65,7 +79,7 @@ namespace Yoga
 
         ChildIterator& operator--()
         {
-            --_index;
+            --_child;
             return *this;
         }
 
@@ -78,136 +92,1730 @@ namespace Yoga
 
         ChildIterator& operator+=(const difference_type offset)
         {
-            _index += offset;
+            _child += offset;
             return *this;
         }
 
         ChildIterator& operator-=(const difference_type offset)
         {
-            _index -= offset;
+            _child -= offset;
             return *this;
         }
 
         friend ChildIterator operator+(const ChildIterator& it, difference_type offset)
         {
-            return ChildIterator{it._parent, it._index + offset, it._size};
+            return ChildIterator{it._child + offset};
         }
 
         friend ChildIterator operator+(difference_type offset, const ChildIterator& it) { return it + offset; }
 
         friend ChildIterator operator-(const ChildIterator& it, difference_type offset)
         {
-            return ChildIterator{it._parent, it._index - offset, it._size};
+            return ChildIterator{it._child - offset};
         }
 
-        difference_type operator-(const ChildIterator& other) const { return _index - other._index; }
+        difference_type operator-(const ChildIterator& other) const { return _child - other._child; }
 
-        bool operator==(const ChildIterator& other) const { return _index == other._index; }
-        bool operator!=(const ChildIterator& other) const { return _index != other._index; }
-        bool operator<(const ChildIterator& other) const { return _index < other._index; }
-        bool operator>(const ChildIterator& other) const { return _index > other._index; }
-        bool operator<=(const ChildIterator& other) const { return _index <= other._index; }
-        bool operator>=(const ChildIterator& other) const { return _index >= other._index; }
+        bool operator==(const ChildIterator& other) const = default;
+        auto operator<=>(const ChildIterator& other) const = default;
 
     private:
-        Node _parent;
-        difference_type _index;
-        size_t _size;
-        Node _proxyNode;
+        facebook::yoga::Node* const* _child = nullptr;
     };
 
+    /**
+     * The children of a node, as a sized random access range of handles.
+     *
+     * The range captures the parent's child array once on construction; see ChildIterator for when it is
+     * invalidated.
+     */
     template <typename Node>
     class ChildRange : public std::ranges::view_interface<ChildRange<Node>>
     {
     public:
         ChildRange() = default;
 
-        explicit ChildRange(const Node& parent) : _parent{parent} {}
+        explicit ChildRange(const Node& parent)
+        {
+            if (parent.valid())
+            {
+                const auto& children = facebook::yoga::resolveRef(parent.get())->getChildren();
+                _first = children.data();
+                _last = _first + children.size();
+            }
+        }
+
+        ChildIterator<Node> begin() const { return ChildIterator<Node>{_first}; }
+
+        ChildIterator<Node> end() const { return ChildIterator<Node>{_last}; }
+
+    private:
+        facebook::yoga::Node* const* _first = nullptr;
+        facebook::yoga::Node* const* _last = nullptr;
+    };
+
+    /**
+     * Chunked object pool used by NodeRegistry for context storage.
+     *
+     * Objects are constructed in place inside fixed-size chunks. Chunks are never moved or freed while the pool
+     * is alive, so object addresses are stable and can be handed to YGNodeSetContext. Destroyed objects return
+     * their slot to a free list which is reused by the next allocation.
+     *
+     * The pool does not track which slots are live; owners must destroy every object they create before the
+     * pool itself is destroyed.
+     */
+    template <typename T, size_t ChunkSize = 64>
+    class ContextPool
+    {
+    public:
+        ContextPool() = default;
+
+        ContextPool(const ContextPool&) = delete;
+        ContextPool& operator=(const ContextPool&) = delete;
+        ContextPool(ContextPool&&) = delete;
+        ContextPool& operator=(ContextPool&&) = delete;
+
+        /**
+         * Constructs an object in a free slot, allocating a new chunk only when the free list is empty.
+         * @return Stable pointer to the new object
+         */
+        template <typename... Args>
+        T* create(Args&&... args)
+        {
+            Slot* slot = acquire();
+            try
+            {
+                auto* object = std::construct_at(reinterpret_cast<T*>(slot->storage), std::forward<Args>(args)...);
+                ++_size;
+                return object;
+            }
+            catch (...)
+            {
+                release(slot);
+                throw;
+            }
+        }
+
+        /**
+         * Destroys an object previously returned by create() and recycles its slot.
+         */
+        void destroy(T* object) noexcept
+        {
+            assert(object != nullptr && "Cannot destroy a null object");
+            std::destroy_at(object);
+            release(reinterpret_cast<Slot*>(object));
+            --_size;
+        }
+
+        /**
+         * @return Number of live objects
+         */
+        [[nodiscard]] size_t size() const noexcept { return _size; }
+
+        /**
+         * @return Number of slots allocated across all chunks
+         */
+        [[nodiscard]] size_t capacity() const noexcept { return _chunks.size() * ChunkSize; }
+
+        /**
+         * Allocates chunks up front so that the next count objects can be created without further allocation.
+         */
+        void reserve(const size_t count)
+        {
+            while (capacity() - _size < count)
+            {
+                _chunks.push_back(std::make_unique_for_overwrite<Slot[]>(ChunkSize));
+            }
+        }
+
+    private:
+        union Slot
+        {
+            Slot* next;
+            alignas(T) std::byte storage[sizeof(T)];
+        };
 
-        ChildIterator<Node> begin() const
+        Slot* acquire()
         {
-            if (!_parent.valid())
+            if (_freeList != nullptr)
+            {
+                Slot* slot = _freeList;
+                _freeList = slot->next;
+                return slot;
+            }
+
+            if (_carved == capacity())
             {
-                return ChildIterator<Node>{};
+                _chunks.push_back(std::make_unique_for_overwrite<Slot[]>(ChunkSize));
             }
 
-            return ChildIterator<Node>{_parent};
+            const auto index = _carved++;
+            return &_chunks[index / ChunkSize][index % ChunkSize];
+        }
+
+        void release(Slot* slot) noexcept
+        {
+            slot->next = _freeList;
+            _freeList = slot;
+        }
+
+        std::vector<std::unique_ptr<Slot[]>> _chunks;
+        Slot* _freeList = nullptr;
+        size_t _carved = 0;
+        size_t _size = 0;
+    };
+
+    /**
+     * Remembers the most recent measure results of a single node.
+     *
+     * Yoga measures the same leaf several times with identical constraints while resolving flexible sizes.
+     * Results are keyed by both constraints and their modes; once the cache is full the oldest entry is replaced.
+     */
+    class MeasureCache
+    {
+    public:
+        explicit MeasureCache(const size_t capacity) : _capacity{capacity} { _entries.reserve(capacity); }
+
+        /**
+         * @return The cached size for these constraints, or nullptr on a miss
+         */
+        [[nodiscard]] const YGSize* find(const float width, const YGMeasureMode widthMode, const float height,
+                                         const YGMeasureMode heightMode) const noexcept
+        {
+            for (const auto& entry : _entries)
+            {
+                if (sameConstraint(entry.width, entry.widthMode, width, widthMode) &&
+                    sameConstraint(entry.height, entry.heightMode, height, heightMode))
+                {
+                    return &entry.size;
+                }
+            }
+            return nullptr;
         }
 
-        ChildIterator<Node> end() const
+        /**
+         * Records a measure result, evicting the oldest entry if the cache is full.
+         */
+        void store(const float width, const YGMeasureMode widthMode, const float height,
+                   const YGMeasureMode heightMode, const YGSize size)
         {
-            if (!_parent.valid())
+            if (_capacity == 0)
+            {
+                return;
+            }
+
+            const Entry entry{width, widthMode, height, heightMode, size};
+            if (_entries.size() < _capacity)
             {
-                return ChildIterator<Node>{};
+                _entries.push_back(entry);
+                return;
             }
 
-            const auto count = _parent.getChildCount();
+            _entries[_next] = entry;
+            _next = (_next + 1) % _capacity;
+        }
 
-            return ChildIterator<Node>{_parent, static_cast<std::ptrdiff_t>(count), count};
+        /**
+         * Forgets every cached result.
+         */
+        void clear() noexcept
+        {
+            _entries.clear();
+            _next = 0;
         }
 
+        [[nodiscard]] size_t size() const noexcept { return _entries.size(); }
+        [[nodiscard]] size_t capacity() const noexcept { return _capacity; }
+
     private:
-        Node _parent;
+        struct Entry
+        {
+            float width;
+            YGMeasureMode widthMode;
+            float height;
+            YGMeasureMode heightMode;
+            YGSize size;
+        };
+
+        // Yoga passes an undefined (NaN) length when the mode is undefined, so only the mode is compared then.
+        static bool sameConstraint(const float a, const YGMeasureMode aMode, const float b,
+                                   const YGMeasureMode bMode) noexcept
+        {
+            return aMode == bMode && (aMode == YGMeasureModeUndefined || a == b);
+        }
+
+        std::vector<Entry> _entries;
+        size_t _capacity;
+        size_t _next = 0;
     };
 
     template <typename Ctx>
     class Layout;
 
-    template <typename Ctx>
-    class Node;
+    template <typename Ctx>
+    class Node;
+
+    template <typename Ctx>
+    class DetachedSubtree;
+
+    template <typename Ctx>
+    class ConcurrentLayout;
+
+    /**
+     * Generational slot map that records which Yoga nodes a Layout owns, and stores their contexts.
+     *
+     * Slots are addressed by a dense index and live in fixed-size chunks, so a slot's address never changes and
+     * can be stored as the Yoga node context. Every release bumps the slot's generation; an (index, generation)
+     * pair therefore only resolves while the node it was issued for is alive. Acquire, release and lookup are
+     * O(1) and iteration visits live slots in index order.
+     *
+     * Each slot points back at its registry, and the registry at its owning Layout, so Yoga callbacks that only
+     * receive a node can reach the layout it belongs to. A layout may own several registries.
+     */
+    template <typename Ctx, size_t ChunkSize = 64>
+    class NodeRegistry
+    {
+    public:
+        using owner_type = Layout<Ctx>;
+
+        static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+        struct Slot
+        {
+            YGNodeRef node = nullptr;
+            Ctx* context = nullptr;
+            NodeRegistry* registry = nullptr;
+            uint32_t index = 0;
+            uint32_t generation = 0;
+            uint32_t nextFree = npos;
+            std::unique_ptr<MeasureCache> measureCache;
+            // The measure function was installed by Layout::setDefaultMeasure rather than by the node's owner.
+            bool defaultMeasure = false;
+        };
+
+        explicit NodeRegistry(owner_type* owner) : _owner{owner} {}
+
+        ~NodeRegistry() { trimSpares(0); }
+
+        NodeRegistry(const NodeRegistry&) = delete;
+        NodeRegistry& operator=(const NodeRegistry&) = delete;
+        NodeRegistry(NodeRegistry&&) = delete;
+        NodeRegistry& operator=(NodeRegistry&&) = delete;
+
+        /**
+         * Claims a slot for a node, reusing the most recently released slot if there is one, and constructs the
+         * node's context from args. Nothing is claimed if the context constructor throws.
+         * @return The claimed slot, whose address is stable for the registry's lifetime
+         */
+        template <typename... Args>
+        Slot& acquire(const YGNodeRef node, Args&&... args)
+        {
+            if (_freeHead == npos && _end == _chunks.size() * ChunkSize)
+            {
+                _chunks.push_back(std::make_unique<Slot[]>(ChunkSize));
+            }
+            auto* context = _contexts.create(std::forward<Args>(args)...);
+
+            Slot* slot;
+            if (_freeHead != npos)
+            {
+                slot = &at(_freeHead);
+                _freeHead = slot->nextFree;
+            }
+            else
+            {
+                slot = &at(_end);
+                slot->registry = this;
+                slot->index = _end++;
+            }
+
+            slot->node = node;
+            slot->context = context;
+            slot->nextFree = npos;
+            ++_size;
+            return *slot;
+        }
+
+        /**
+         * Destroys the slot's context, returns the slot to the free list and invalidates every (index, generation)
+         * pair issued for it.
+         */
+        void release(Slot& slot) noexcept
+        {
+            assert(slot.node != nullptr && "Slot is not in use");
+            _contexts.destroy(slot.context);
+            slot.node = nullptr;
+            slot.context = nullptr;
+            // Keep the cache's memory for the next node in this slot; an empty cache answers nothing.
+            if (slot.measureCache != nullptr)
+            {
+                slot.measureCache->clear();
+            }
+            slot.defaultMeasure = false;
+            ++slot.generation;
+            slot.nextFree = _freeHead;
+            _freeHead = slot.index;
+            --_size;
+        }
+
+        /**
+         * Invokes fn on every live slot in ascending index order.
+         */
+        template <typename Fn>
+        void forEach(Fn&& fn)
+        {
+            for (uint32_t index = 0; index < _end; ++index)
+            {
+                Slot& slot = at(index);
+                if (slot.node != nullptr)
+                {
+                    fn(slot);
+                }
+            }
+        }
+
+        /**
+         * @return Number of live slots
+         */
+        [[nodiscard]] size_t size() const noexcept { return _size; }
+
+        /**
+         * @return The layout that owns this registry
+         */
+        [[nodiscard]] owner_type* owner() const noexcept { return _owner; }
+
+        /**
+         * Hands the registry, and with it every node it holds, to another layout.
+         */
+        void setOwner(owner_type* owner) noexcept { _owner = owner; }
+
+        /**
+         * Allocates slots and context storage up front so that the next count acquisitions do not allocate.
+         */
+        void reserve(const size_t count)
+        {
+            _contexts.reserve(count);
+            while (_chunks.size() * ChunkSize - _size < count)
+            {
+                _chunks.push_back(std::make_unique<Slot[]>(ChunkSize));
+            }
+        }
+
+        /**
+         * Keeps a detached, reset Yoga node for a later acquisition instead of freeing it.
+         */
+        void addSpare(const YGNodeRef node) { _spares.push_back(node); }
+
+        /**
+         * @return A kept Yoga node, or nullptr if there is none; either outcome is counted
+         */
+        [[nodiscard]] YGNodeRef takeSpare() noexcept
+        {
+            if (_spares.empty())
+            {
+                ++_spareMisses;
+                return nullptr;
+            }
+
+            ++_spareHits;
+            const auto node = _spares.back();
+            _spares.pop_back();
+            return node;
+        }
+
+        /**
+         * Preallocates room for count kept Yoga nodes, so that adding them cannot fail.
+         */
+        void reserveSpares(const size_t count) { _spares.reserve(count); }
+
+        /**
+         * Moves every Yoga node kept by other into this registry's pool.
+         */
+        void takeSpares(NodeRegistry& other)
+        {
+            _spares.insert(_spares.end(), other._spares.begin(), other._spares.end());
+            other._spares.clear();
+        }
+
+        /**
+         * Frees kept Yoga nodes until at most count remain.
+         */
+        void trimSpares(const size_t count) noexcept
+        {
+            while (_spares.size() > count)
+            {
+                YGNodeFree(_spares.back());
+                _spares.pop_back();
+            }
+        }
+
+        [[nodiscard]] size_t spareCount() const noexcept { return _spares.size(); }
+        [[nodiscard]] size_t spareHits() const noexcept { return _spareHits; }
+        [[nodiscard]] size_t spareMisses() const noexcept { return _spareMisses; }
+
+        /**
+         * @return Mutex for owners that share the registry between threads; the registry itself never locks
+         */
+        [[nodiscard]] std::mutex& mutex() noexcept { return _mutex; }
+
+    private:
+        Slot& at(const uint32_t index) noexcept { return _chunks[index / ChunkSize][index % ChunkSize]; }
+
+        owner_type* _owner;
+        ContextPool<Ctx> _contexts;
+        std::mutex _mutex;
+        std::vector<YGNodeRef> _spares;
+        size_t _spareHits = 0;
+        size_t _spareMisses = 0;
+        std::vector<std::unique_ptr<Slot[]>> _chunks;
+        uint32_t _end = 0;
+        uint32_t _freeHead = npos;
+        size_t _size = 0;
+    };
+
+    /**
+     * A context type that can measure its own content, e.g. a text run.
+     */
+    template <typename Ctx>
+    concept Measurable = requires(Ctx& ctx, float width, YGMeasureMode widthMode, float height,
+                                  YGMeasureMode heightMode) {
+        { ctx.measure(width, widthMode, height, heightMode) } -> std::convertible_to<YGSize>;
+    };
+
+    /**
+     * A stateless callable that measures a node from its context.
+     *
+     * Statelessness lets Node dispatch to it through a static function generated per callable type, so no
+     * per-node storage or allocation is needed. Captureless lambdas satisfy this.
+     */
+    template <typename Fn, typename Ctx>
+    concept MeasureFunction =
+        std::is_empty_v<Fn> && std::default_initializable<Fn> &&
+        std::is_invocable_r_v<YGSize, Fn&, Ctx&, float, YGMeasureMode, float, YGMeasureMode>;
+
+    /**
+     * A context type that can report the baseline of its own content, e.g. the first line of a text run.
+     */
+    template <typename Ctx>
+    concept HasBaseline = requires(Ctx& ctx, float width, float height) {
+        { ctx.baseline(width, height) } -> std::convertible_to<float>;
+    };
+
+    /**
+     * A stateless callable that computes a node's baseline from its context and laid out size.
+     *
+     * Dispatched the same way as MeasureFunction, through a static function generated per callable type.
+     */
+    template <typename Fn, typename Ctx>
+    concept BaselineFunction = std::is_empty_v<Fn> && std::default_initializable<Fn> &&
+                               std::is_invocable_r_v<float, Fn&, Ctx&, float, float>;
+
+    /**
+     * A stateless callable notified when a node becomes dirty.
+     */
+    template <typename Fn, typename NodeT>
+    concept DirtiedFunction =
+        std::is_empty_v<Fn> && std::default_initializable<Fn> && std::is_invocable_v<Fn&, NodeT>;
+
+    /**
+     * Runs a callable for every index of a range, possibly concurrently, and returns once all calls finished.
+     * ThreadPool is one.
+     *
+     * The callable is a stateful lambda, so parallelFor must accept any function object invocable with an
+     * index, either as a template parameter or through std::function; a plain function pointer is not enough.
+     */
+    template <typename Executor>
+    concept ParallelExecutor = requires(Executor& executor, size_t count, const std::function<void(size_t)>& fn) {
+        executor.parallelFor(count, fn);
+    };
+
+    /**
+     * Layout result of a single node, relative to its parent.
+     */
+    template <typename NodeT>
+    struct LayoutRecord
+    {
+        NodeT node;
+        float left;
+        float top;
+        float width;
+        float height;
+    };
+
+    /**
+     * Edit script that turns one ordered child list into another.
+     *
+     * Children are matched by identity. Kept children that already appear in the longest increasing run of
+     * their old positions stay in place; every other old child is removed and every other new child is
+     * inserted, so moves are expressed as a removal plus an insertion.
+     */
+    struct ChildrenDiff
+    {
+        // Indices into the current child list to remove, ascending.
+        std::vector<size_t> removals;
+        // Indices into the target child list to insert, ascending.
+        std::vector<size_t> insertions;
+
+        [[nodiscard]] bool empty() const noexcept { return removals.empty() && insertions.empty(); }
+    };
+
+    /**
+     * Computes the minimal edit script between two child lists.
+     * @param current The children as they are now
+     * @param next The children as they should be
+     * @return Removals and insertions that turn current into next
+     */
+    ChildrenDiff diffChildren(std::span<const YGNodeRef> current, std::span<const YGNodeRef> next);
+
+    /**
+     * Owning wrapper around a Yoga configuration.
+     *
+     * A Config is shared by every node created through a Layout constructed with it, and must outlive that
+     * Layout. Changes made after nodes exist take effect on their next layout calculation.
+     */
+    class Config
+    {
+    public:
+        Config() : _config{YGConfigNew()} {}
+        ~Config()
+        {
+            if (_config != nullptr)
+            {
+                YGConfigFree(_config);
+            }
+        }
+
+        Config(const Config&) = delete;
+        Config& operator=(const Config&) = delete;
+
+        Config(Config&& other) noexcept : _config{std::exchange(other._config, nullptr)} {}
+        Config& operator=(Config&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (_config != nullptr)
+                {
+                    YGConfigFree(_config);
+                }
+                _config = std::exchange(other._config, nullptr);
+            }
+            return *this;
+        }
+
+        [[nodiscard]] YGConfigRef get() const noexcept { return _config; }
+
+        /**
+         * Sets how many physical pixels make up one layout point.
+         *
+         * Layout results are rounded to this pixel grid after every calculation. A value of 0 disables
+         * rounding entirely, which skips the rounding pass for trees that are never drawn directly.
+         *
+         * @param pointScaleFactor Physical pixels per point, or 0 to disable rounding
+         */
+        void setPointScaleFactor(const float pointScaleFactor) noexcept
+        {
+            YGConfigSetPointScaleFactor(_config, pointScaleFactor);
+        }
+
+        /**
+         * @return Physical pixels per point, or 0 if rounding is disabled
+         */
+        [[nodiscard]] float getPointScaleFactor() const noexcept { return YGConfigGetPointScaleFactor(_config); }
+
+        /**
+         * Selects which historical layout bugs Yoga should keep reproducing for compatibility.
+         * @param errata Bitmask of errata to enable
+         */
+        void setErrata(const YGErrata errata) noexcept { YGConfigSetErrata(_config, errata); }
+
+        /**
+         * @return Bitmask of enabled errata
+         */
+        [[nodiscard]] YGErrata getErrata() const noexcept { return YGConfigGetErrata(_config); }
+
+        /**
+         * Switches style defaults to match the web (row direction, shrinkable flex items, etc.).
+         * @param useWebDefaults Whether to use web defaults for nodes created with this config
+         */
+        void setUseWebDefaults(const bool useWebDefaults) noexcept
+        {
+            YGConfigSetUseWebDefaults(_config, useWebDefaults);
+        }
+
+        /**
+         * @return Whether nodes created with this config use web defaults
+         */
+        [[nodiscard]] bool getUseWebDefaults() const noexcept { return YGConfigGetUseWebDefaults(_config); }
+
+        /**
+         * @param feature The experimental feature to toggle
+         * @param enabled Whether the feature should be enabled
+         */
+        void setExperimentalFeatureEnabled(const YGExperimentalFeature feature, const bool enabled) noexcept
+        {
+            YGConfigSetExperimentalFeatureEnabled(_config, feature, enabled);
+        }
+
+        /**
+         * @param feature The experimental feature to query
+         * @return Whether the feature is enabled
+         */
+        [[nodiscard]] bool isExperimentalFeatureEnabled(const YGExperimentalFeature feature) const noexcept
+        {
+            return YGConfigIsExperimentalFeatureEnabled(_config, feature);
+        }
+
+    private:
+        YGConfigRef _config;
+    };
+
+    /**
+     * Whether Layout::clear() keeps destroyed Yoga nodes for reuse.
+     */
+    enum class KeepCapacity : bool
+    {
+        No,
+        Yes,
+    };
+
+    template <typename Ctx>
+    class Layout
+    {
+    public:
+        using context_type = Ctx;
+        using node_type = Node<Ctx>;
+        using registry_type = NodeRegistry<Ctx>;
+        using record_type = LayoutRecord<Node<Ctx>>;
+
+        Layout() = default;
+
+        /**
+         * Creates a layout whose nodes all use the given configuration.
+         * @param config Configuration shared by every node of this layout; must outlive the layout
+         */
+        explicit Layout(const Config& config) : _config{config.get()} {}
+
+        ~Layout()
+        {
+            // Freeing nodes dirties their parents; nobody is left to observe that.
+            _dispatchDirtied = false;
+            forEachRegistry(
+                [](registry_type& registry)
+                {
+                    registry.forEach(
+                        [&registry](auto& slot)
+                        {
+                            YGNodeFree(slot.node);
+                            registry.release(slot);
+                        });
+                });
+        }
+
+        // Pin layout in memory since it's a manager.
+        Layout(const Layout&) = delete;
+        Layout& operator=(const Layout&) = delete;
+        Layout(Layout&&) = delete;
+        Layout& operator=(Layout&&) = delete;
+
+        template <typename... Args>
+        node_type createNode(Args&&... args)
+        {
+            assert(!_concurrentPhase.load(std::memory_order_relaxed) &&
+                   "Nodes cannot be created while a concurrent layout is running");
+            auto& registry = localRegistry();
+            std::unique_lock lock{registry.mutex(), std::defer_lock};
+            if (_concurrent)
+            {
+                lock.lock();
+            }
+
+            // Nodes kept by clear() are reused even with recycling off.
+            YGNodeRef ygNode = _recycleLimit > 0 || registry.spareCount() > 0 ? registry.takeSpare() : nullptr;
+            if (ygNode == nullptr)
+            {
+                ygNode = _config != nullptr ? YGNodeNewWithConfig(_config) : YGNodeNew();
+            }
+
+            typename registry_type::Slot* slot;
+            try
+            {
+                slot = &registry.acquire(ygNode, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                YGNodeFree(ygNode);
+                throw;
+            }
+            YGNodeSetContext(ygNode, slot);
+            if (_trackDirtied)
+            {
+                YGNodeSetDirtiedFunc(ygNode, &node_type::template dirtiedTrampoline<void>);
+            }
+            node_type node{ygNode};
+            node.installDefaultMeasure();
+            return node;
+        }
+
+        void destroyNode(node_type& node)
+        {
+            if (node.get() == nullptr)
+                return;
+
+            assert(node.valid() && "Node has already been destroyed");
+            assert((!node.valid() || node.layout() == this) && "Layout does not contain this node");
+            assert(!_concurrentPhase.load(std::memory_order_relaxed) &&
+                   "Nodes cannot be destroyed while a concurrent layout is running");
+            if (node.valid() && node.layout() == this)
+            {
+                auto* slot = node._slot;
+                auto& registry = *slot->registry;
+                std::unique_lock lock{registry.mutex(), std::defer_lock};
+                if (_concurrent)
+                {
+                    lock.lock();
+                }
+
+                retire(registry, *slot);
+                node.invalidate();
+            }
+        }
+
+        /**
+         * Destroys a node together with all of its descendants.
+         *
+         * Only the top node is removed from its parent. The rest are freed parent first, so by the time a child
+         * is freed its parent is already gone and there is no sibling array left to remove it from; the whole
+         * teardown is linear in the size of the subtree.
+         *
+         * @param node Top of the subtree; invalidated like every other handle into the subtree
+         * @return Number of destroyed nodes
+         */
+        size_t destroySubtree(node_type& node)
+        {
+            if (node.get() == nullptr)
+                return 0;
+
+            assert(node.valid() && "Node has already been destroyed");
+            assert((!node.valid() || node.layout() == this) && "Layout does not contain this node");
+            assert(!_concurrentPhase.load(std::memory_order_relaxed) &&
+                   "Nodes cannot be destroyed while a concurrent layout is running");
+            if (!node.valid() || node.layout() != this)
+            {
+                return 0;
+            }
+
+            if (const auto owner = YGNodeGetOwner(node.get()); owner != nullptr)
+            {
+                YGNodeRemoveChild(owner, node.get());
+            }
+
+            // Concurrent layouts may tear down several subtrees at once, so they cannot share the walk stack.
+            std::vector<YGNodeRef> localWalk;
+            auto& walk = _concurrent ? localWalk : _walk;
+            walk.clear();
+            walk.push_back(node.get());
+            size_t destroyed = 0;
+            while (!walk.empty())
+            {
+                const auto ygNode = walk.back();
+                walk.pop_back();
+                const auto& children = facebook::yoga::resolveRef(ygNode)->getChildren();
+                walk.insert(walk.end(), children.begin(), children.end());
+
+                auto& slot = node_type::slotOf(ygNode);
+                assert(slot.registry->owner() == this && "Subtree contains a node of another layout");
+                auto& registry = *slot.registry;
+                std::unique_lock lock{registry.mutex(), std::defer_lock};
+                if (_concurrent)
+                {
+                    lock.lock();
+                }
+                retire(registry, slot);
+                ++destroyed;
+            }
+
+            node.invalidate();
+            return destroyed;
+        }
+
+        /**
+         * Destroys every node of the layout at once, for layouts rebuilt from scratch every frame.
+         *
+         * All handles are invalidated and no dirtied callbacks run. Registry slots and context storage are always
+         * kept for the next nodes. With KeepCapacity::Yes every Yoga node is also reset and moved into the calling
+         * thread's pool, regardless of the recycle limit, together with nodes pooled elsewhere such as in adopted
+         * subtrees. A frame that creates no more nodes than the previous one then does not allocate in this
+         * wrapper once this thread's registry has grown to the frame size; Yoga still allocates each node's child
+         * list again as children are inserted. Slots of adopted subtrees are kept but not reused. With
+         * KeepCapacity::No the Yoga nodes, including any kept by recycling, are freed.
+         *
+         * No other thread may use the layout while it is cleared.
+         */
+        void clear(const KeepCapacity keep = KeepCapacity::Yes)
+        {
+            assert(!_concurrentPhase.load(std::memory_order_relaxed) &&
+                   "Nodes cannot be destroyed while a concurrent layout is running");
+
+            // Make room for every node in this thread's pool up front; nothing below allocates.
+            registry_type* pool = nullptr;
+            if (keep == KeepCapacity::Yes)
+            {
+                pool = &localRegistry();
+                size_t count = 0;
+                forEachRegistry([&count](const registry_type& registry)
+                                { count += registry.size() + registry.spareCount(); });
+                pool->reserveSpares(count);
+            }
+
+            // Detaching and resetting nodes dirties them; nobody is left to observe that.
+            const bool dispatchDirtied = _dispatchDirtied;
+            _dispatchDirtied = false;
+
+            // Detach everything first so that no node still has an owner when it is reset or freed.
+            forEachRegistry(
+                [](registry_type& registry)
+                {
+                    registry.forEach(
+                        [](auto& slot)
+                        {
+                            YGNodeSetDirtiedFunc(slot.node, nullptr);
+                            YGNodeRemoveAllChildren(slot.node);
+                        });
+                });
+
+            forEachRegistry(
+                [pool](registry_type& registry)
+                {
+                    registry.forEach(
+                        [&registry, pool](auto& slot)
+                        {
+                            const auto ygNode = slot.node;
+                            registry.release(slot);
+                            if (pool != nullptr)
+                            {
+                                YGNodeReset(ygNode);
+                                pool->addSpare(ygNode);
+                            }
+                            else
+                            {
+                                YGNodeFree(ygNode);
+                            }
+                        });
+                    if (pool == nullptr)
+                    {
+                        registry.trimSpares(0);
+                    }
+                    else if (&registry != pool)
+                    {
+                        pool->takeSpares(registry);
+                    }
+                });
+
+            _dispatchDirtied = dispatchDirtied;
+            _dirtied.clear();
+        }
+
+        /**
+         * Creates one node per element of nodes, each with a context constructed from a copy of args.
+         *
+         * Registry and context storage for the whole batch is reserved before any node is created, so the
+         * contexts of a fresh batch are packed contiguously.
+         *
+         * @param nodes Output storage that receives the new handles
+         * @return The filled span
+         */
+        template <typename... Args>
+        std::span<node_type> createNodes(std::span<node_type> nodes, const Args&... args)
+        {
+            reserve(nodes.size());
+            for (auto& node : nodes)
+            {
+                node = createNode(args...);
+            }
+            return nodes;
+        }
+
+        /**
+         * Creates count nodes, each with a context constructed from a copy of args.
+         * @return Handles to the new nodes, in creation order
+         */
+        template <typename... Args>
+        std::vector<node_type> createNodes(const size_t count, const Args&... args)
+        {
+            std::vector<node_type> nodes(count);
+            createNodes(std::span<node_type>{nodes}, args...);
+            return nodes;
+        }
+
+        /**
+         * Preallocates storage so that the next count nodes can be registered without growing the layout.
+         * On a ConcurrentLayout this reserves storage for the calling thread.
+         */
+        void reserve(const size_t count)
+        {
+            auto& registry = localRegistry();
+            std::unique_lock lock{registry.mutex(), std::defer_lock};
+            if (_concurrent)
+            {
+                lock.lock();
+            }
+            registry.reserve(count);
+        }
+
+        /**
+         * @return Number of live nodes owned by this layout
+         */
+        [[nodiscard]] size_t size() const noexcept
+        {
+            size_t size = 0;
+            forEachRegistry([&size](const registry_type& registry) { size += registry.size(); });
+            return size;
+        }
+
+        /**
+         * Enables memoization of measure results.
+         *
+         * Measure functions installed after this call remember their last size results per node and answer
+         * repeated queries with the same constraints without calling the measure function. Yoga already skips
+         * clean leaves on its own, so this pays off for leaves dirtied without their content changing, e.g. by a
+         * margin change, which Yoga would measure again. The cache of a node is cleared by Node::markDirty(),
+         * which must be called when its content changes anyway.
+         *
+         * @param size Number of results to keep per node, or 0 to disable caching
+         */
+        void setMeasureCacheSize(const size_t size) noexcept { _measureCacheSize = size; }
+
+        /**
+         * @return Number of measure results kept per node, or 0 if caching is disabled
+         */
+        [[nodiscard]] size_t getMeasureCacheSize() const noexcept { return _measureCacheSize; }
+
+        /**
+         * Measures leaves with the context's own measure() member unless told otherwise.
+         *
+         * Nodes created (or reset) after this call get the measure function of Node::setMeasureFunc() installed.
+         * Yoga does not measure nodes with children, so the default is taken off a node as soon as it is given a
+         * child and is not put back if it becomes a leaf again. Measure functions set or unset explicitly on a
+         * node are left alone.
+         *
+         * @param enable Whether new nodes are measured through their context
+         */
+        void setDefaultMeasure(const bool enable) noexcept
+            requires Measurable<context_type>
+        {
+            _defaultMeasure = enable;
+        }
+
+        /**
+         * @return Whether new nodes are measured through their context
+         */
+        [[nodiscard]] bool getDefaultMeasure() const noexcept { return _defaultMeasure; }
+
+        /**
+         * Keeps destroyed Yoga nodes for reuse instead of freeing them.
+         *
+         * A destroyed node is detached from its parent and children, reset with YGNodeReset and kept, up to
+         * limit nodes, to be handed out by the next createNode call in place of a fresh allocation. Lowering the
+         * limit frees the excess right away. On a ConcurrentLayout the limit applies to each thread's pool.
+         *
+         * @param limit Maximum number of kept nodes, or 0 to free destroyed nodes immediately
+         */
+        void setRecycleLimit(const size_t limit)
+        {
+            _recycleLimit = limit;
+            forEachRegistry(
+                [this](registry_type& registry) { registry.trimSpares(_recycleLimit); });
+        }
+
+        /**
+         * @return Maximum number of kept nodes per pool
+         */
+        [[nodiscard]] size_t getRecycleLimit() const noexcept { return _recycleLimit; }
+
+        struct RecycleStats
+        {
+            // createNode calls served from the pool, and those that had to allocate while recycling was on.
+            size_t hits = 0;
+            size_t misses = 0;
+            // Nodes currently kept.
+            size_t pooled = 0;
+
+            [[nodiscard]] double hitRate() const noexcept
+            {
+                return hits + misses > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+            }
+        };
+
+        /**
+         * @return Node recycling counters summed over every pool of this layout
+         */
+        [[nodiscard]] RecycleStats getRecycleStats() const noexcept
+        {
+            RecycleStats stats;
+            forEachRegistry(
+                [&stats](const registry_type& registry)
+                {
+                    stats.hits += registry.spareHits();
+                    stats.misses += registry.spareMisses();
+                    stats.pooled += registry.spareCount();
+                });
+            return stats;
+        }
+
+        /**
+         * Records every node that becomes dirty so the application can repaint only what changed.
+         *
+         * While enabled, a node is appended to the dirtied list whenever it goes from clean to dirty, including
+         * ancestors dirtied by propagation, so each node appears at most once per layout pass. Nodes with their
+         * own dirtied function (see Node::setDirtiedFunc) are recorded as well.
+         *
+         * @param track Whether to record dirtied nodes
+         */
+        void setTrackDirtied(const bool track)
+        {
+            _trackDirtied = track;
+            constexpr YGDirtiedFunc tracker = &node_type::template dirtiedTrampoline<void>;
+            forEachRegistry(
+                [track, tracker](registry_type& registry)
+                {
+                    registry.forEach(
+                        [track, tracker](auto& slot)
+                        {
+                            const auto current = YGNodeGetDirtiedFunc(slot.node);
+                            if (track && current == nullptr)
+                            {
+                                YGNodeSetDirtiedFunc(slot.node, tracker);
+                            }
+                            else if (!track && current == tracker)
+                            {
+                                YGNodeSetDirtiedFunc(slot.node, nullptr);
+                            }
+                        });
+                });
+        }
+
+        /**
+         * @return Whether dirtied nodes are being recorded
+         */
+        [[nodiscard]] bool getTrackDirtied() const noexcept { return _trackDirtied; }
+
+        /**
+         * @return Nodes dirtied since the list was last drained or cleared, in the order they were dirtied.
+         * Entries may have been destroyed since; check valid() before use.
+         *
+         * Not available on a ConcurrentLayout, whose workers may append while the span is in use; its own
+         * getDirtied() returns a copy instead.
+         */
+        [[nodiscard]] std::span<const node_type> getDirtied() const noexcept
+        {
+            assert(!_concurrent && "Dirtied list of a concurrent layout must be copied");
+            return _dirtied;
+        }
+
+        /**
+         * Invokes fn on every recorded node that is still alive, then empties the list.
+         *
+         * Nodes dirtied from within fn are kept for the next drain.
+         *
+         * @param fn Callable taking a node handle
+         */
+        template <typename Fn>
+        void drainDirtied(Fn&& fn)
+        {
+            {
+                std::unique_lock lock{_dirtiedMutex, std::defer_lock};
+                if (_concurrent)
+                {
+                    lock.lock();
+                }
+                std::swap(_dirtied, _draining);
+            }
+            for (auto& node : _draining)
+            {
+                if (node.valid())
+                {
+                    fn(node);
+                }
+            }
+            _draining.clear();
+        }
+
+        /**
+         * Empties the dirtied list without visiting it.
+         */
+        void clearDirtied() noexcept
+        {
+            std::unique_lock lock{_dirtiedMutex, std::defer_lock};
+            if (_concurrent)
+            {
+                lock.lock();
+            }
+            _dirtied.clear();
+        }
+
+        /**
+         * Emits the layout of every node under root whose layout changed in the last calculation.
+         *
+         * Yoga flags each node it lays out with hasNewLayout; a node that was not visited leaves its whole
+         * subtree untouched, so the walk skips any branch whose top node is not flagged. Visited nodes have their
+         * flag cleared and are written to out in pre-order with positions relative to their parent.
+         *
+         * @param root Node to start from, usually the root passed to calculateLayout
+         * @param out Output iterator accepting record_type
+         * @return The output iterator past the last written record
+         */
+        template <typename OutputIt>
+        OutputIt collectUpdated(const node_type& root, OutputIt out)
+        {
+            assert(root.valid() && "Node handle is invalid");
+            // Concurrent layouts may collect several trees at once, so they cannot share the walk stack.
+            std::vector<YGNodeRef> localWalk;
+            auto& walk = _concurrent ? localWalk : _walk;
+            walk.clear();
+            walk.push_back(root.get());
+            while (!walk.empty())
+            {
+                const auto ygNode = walk.back();
+                walk.pop_back();
+                if (!YGNodeGetHasNewLayout(ygNode))
+                {
+                    continue;
+                }
+
+                YGNodeSetHasNewLayout(ygNode, false);
+                *out++ = record_type{node_type{ygNode}, YGNodeLayoutGetLeft(ygNode), YGNodeLayoutGetTop(ygNode),
+                                     YGNodeLayoutGetWidth(ygNode), YGNodeLayoutGetHeight(ygNode)};
+
+                for (auto i = YGNodeGetChildCount(ygNode); i > 0; --i)
+                {
+                    walk.push_back(YGNodeGetChild(ygNode, i - 1));
+                }
+            }
+            return out;
+        }
+
+        /**
+         * Calculates the layout of root's tree, laying out independent subtrees concurrently first.
+         *
+         * A layout boundary is a node whose size does not depend on its parent: point width and height, no flex
+         * grow, shrink or basis unless it is absolutely positioned, no percentage min/max size, padding, margin or
+         * position, and not statically positioned. The outermost dirty boundaries below root are laid out in
+         * parallel, each as a root of its own size, after which the regular pass from root finds them clean and
+         * reuses Yoga's cached results for them. With fewer than two boundaries the tree is laid out serially.
+         * Percentages are excluded because a boundary laid out alone would resolve them against its own size, so
+         * the final pass would miss the cache or, worse, keep a wrong result. Subtrees hidden with display none
+         * are not searched.
+         *
+         * Boundaries are only split off when the configuration's point scale factor is 0. Yoga rounds a pass to
+         * the pixel grid starting from the node it was called on, so a boundary laid out on its own would be
+         * rounded at the origin and rounded again at its real offset by the final pass, which does not match a
+         * serial layout. With rounding enabled this is the same as calculateLayout.
+         *
+         * Measure and baseline functions of nodes inside boundaries run on the executor's threads and must be
+         * safe to call concurrently for different nodes. No node of the tree may be changed until this returns.
+         * The boundary list is kept in the layout to reuse its memory, so this is not reentrant: two calls on the
+         * same layout must not overlap, even for different roots.
+         *
+         * @param root Node to lay out
+         * @param width Available width the layout can take up
+         * @param height Available height the layout can take up
+         * @param executor Runs the boundary layouts, e.g. a ThreadPool
+         * @param direction Reading direction (left-to-right by default)
+         */
+        template <ParallelExecutor Executor>
+        void calculateLayoutParallel(const node_type& root, const float width, const float height, Executor& executor,
+                                     const YGDirection direction = YGDirectionLTR)
+        {
+            assert(root.valid() && "Node handle is invalid");
+            assert(_boundaries.empty() && !_concurrentPhase.load(std::memory_order_relaxed) &&
+                   "Parallel layouts of the same layout cannot overlap");
+            if (YGConfigGetPointScaleFactor(YGNodeGetConfig(root.get())) == 0.f)
+            {
+                collectBoundaries(root.get(), direction);
+            }
+            if (_boundaries.size() > 1)
+            {
+                _concurrentPhase.store(true, std::memory_order_relaxed);
+                try
+                {
+                    executor.parallelFor(_boundaries.size(),
+                                         [this](const size_t i)
+                                         {
+                                             const auto& boundary = _boundaries[i];
+                                             YGNodeCalculateLayout(boundary.node,
+                                                                   YGNodeStyleGetWidth(boundary.node).value,
+                                                                   YGNodeStyleGetHeight(boundary.node).value,
+                                                                   boundary.direction);
+                                         });
+                }
+                catch (...)
+                {
+                    // A measure or baseline function threw; leave the layout usable.
+                    _concurrentPhase.store(false, std::memory_order_relaxed);
+                    _boundaries.clear();
+                    throw;
+                }
+                _concurrentPhase.store(false, std::memory_order_relaxed);
+            }
+            _boundaries.clear();
+            YGNodeCalculateLayout(root.get(), width, height, direction);
+        }
+
+        /**
+         * Calculates the layout of many independent trees concurrently.
+         *
+         * Separate trees share nothing in Yoga but their configuration, which layout only reads, and the
+         * wrapper's per-node state (context, measure cache) is only touched by the thread laying out that node.
+         * Contexts are reached through the node itself rather than a shared lookup, so the registry needs no
+         * locking; it must simply not change, so nodes cannot be created or destroyed until this returns.
+         * Measure and baseline functions run on the executor's threads.
+         *
+         * @param roots Roots of the trees to lay out; each must have no parent
+         * @param sizes Available width and height for each root
+         * @param executor Runs the layouts, e.g. a ThreadPool
+         * @param timings Optional output receiving the wall time spent on each root; empty or one per root
+         * @param direction Reading direction (left-to-right by default)
+         */
+        template <ParallelExecutor Executor>
+        void calculateAll(const std::span<const node_type> roots, const std::span<const YGSize> sizes,
+                          Executor& executor, const std::span<std::chrono::nanoseconds> timings = {},
+                          const YGDirection direction = YGDirectionLTR)
+        {
+            assert(sizes.size() == roots.size() && "Expected one size per root");
+            assert((timings.empty() || timings.size() == roots.size()) && "Expected one timing per root");
+            for (const auto& root : roots)
+            {
+                assert(root.valid() && root.layout() == this && "Root does not belong to this layout");
+                assert(YGNodeGetOwner(root.get()) == nullptr && "Roots must not have a parent");
+            }
+
+            _concurrentPhase.store(true, std::memory_order_relaxed);
+            try
+            {
+                executor.parallelFor(roots.size(),
+                                     [&](const size_t i)
+                                     {
+                                         const auto start = std::chrono::steady_clock::now();
+                                         YGNodeCalculateLayout(roots[i].get(), sizes[i].width, sizes[i].height,
+                                                               direction);
+                                         if (!timings.empty())
+                                         {
+                                             timings[i] = std::chrono::steady_clock::now() - start;
+                                         }
+                                     });
+            }
+            catch (...)
+            {
+                _concurrentPhase.store(false, std::memory_order_relaxed);
+                throw;
+            }
+            _concurrentPhase.store(false, std::memory_order_relaxed);
+        }
+
+        /**
+         * Takes ownership of every node built in a detached subtree.
+         *
+         * The subtree's registries are moved over whole and re-pointed at this layout, so the cost does not
+         * depend on the number of nodes, and existing handles to them stay valid and now belong to this layout.
+         * The subtree's storage is kept as is rather than merged, so adopting many tiny subtrees wastes some
+         * memory compared to creating their nodes here directly.
+         *
+         * @param subtree Subtree built for this layout; empty afterwards
+         * @return The subtree's root, ready to be inserted under a node of this layout
+         */
+        node_type adopt(DetachedSubtree<Ctx>&& subtree)
+        {
+            assert(subtree._layout != nullptr && "Subtree has already been adopted");
+            assert(subtree._layout->_config == _config && "Subtree was built with a different configuration");
+            auto& source = *subtree._layout;
+
+            {
+                std::scoped_lock lock{_registries->mutex, source._registries->mutex};
+                source._nodes->setOwner(this);
+                _registries->entries.push_back({std::thread::id{}, std::move(source._nodes)});
+                for (auto& entry : source._registries->entries)
+                {
+                    entry.registry->setOwner(this);
+                    _registries->entries.push_back({std::thread::id{}, std::move(entry.registry)});
+                }
+                source._registries->entries.clear();
+            }
+
+            const auto root = subtree._root;
+            subtree._layout.reset();
+            return root;
+        }
+
+        /**
+         * Adopts a detached subtree and inserts its root under parent.
+         * @param index Position among parent's children
+         * @return The subtree's root
+         */
+        node_type adopt(DetachedSubtree<Ctx>&& subtree, node_type& parent, const size_t index)
+        {
+            auto root = adopt(std::move(subtree));
+            parent.insertChild(root, index);
+            return root;
+        }
+
+        /**
+         * @return The configuration nodes are created with, or nullptr for Yoga's default configuration
+         */
+        [[nodiscard]] YGConfigConstRef getConfig() const noexcept { return _config; }
+
+    protected:
+        // Creates a layout whose nodes can be created and destroyed from several threads; see ConcurrentLayout.
+        Layout(const YGConfigConstRef config, const bool concurrent) : _config{config}, _concurrent{concurrent} {}
+
+    private:
+        friend class Node<Ctx>;
+        friend class DetachedSubtree<Ctx>;
+        friend class ConcurrentLayout<Ctx>;
+
+        // Frees a node's Yoga node or, while the pool has room, strips and keeps it. The caller holds the lock.
+        void retire(registry_type& registry, typename registry_type::Slot& slot)
+        {
+            const auto ygNode = slot.node;
+            registry.release(slot);
+
+            // YGNodeFree would detach the node without dirtying its parent, so detach it here on both paths;
+            // otherwise the recycle limit would decide whether the parent is laid out again.
+            YGNodeSetDirtiedFunc(ygNode, nullptr);
+            if (const auto owner = YGNodeGetOwner(ygNode); owner != nullptr)
+            {
+                YGNodeRemoveChild(owner, ygNode);
+            }
+            if (registry.spareCount() >= _recycleLimit)
+            {
+                YGNodeFree(ygNode);
+                return;
+            }
+
+            YGNodeRemoveAllChildren(ygNode);
+            YGNodeReset(ygNode);
+            registry.addSpare(ygNode);
+        }
+
+        // Registry the calling thread creates nodes in. A concurrent layout gives each thread its own, so
+        // threads only contend when one destroys a node another created.
+        registry_type& localRegistry()
+        {
+            if (!_concurrent)
+            {
+                assert(_nodes != nullptr && "Layout has been adopted");
+                return *_nodes;
+            }
+
+            struct Cached
+            {
+                uint64_t layoutId = 0;
+                registry_type* registry = nullptr;
+            };
+            thread_local Cached cached;
+            if (cached.layoutId == _id)
+            {
+                return *cached.registry;
+            }
+
+            std::lock_guard lock{_registries->mutex};
+            auto& entries = _registries->entries;
+            const auto thread = std::this_thread::get_id();
+            auto it = std::ranges::find(entries, thread, &ThreadRegistry::thread);
+            if (it == entries.end())
+            {
+                // Take over a registry left by a thread that has ended, or by an adopted subtree, before
+                // adding one, so short-lived threads do not grow the list.
+                it = std::ranges::find(entries, std::thread::id{}, &ThreadRegistry::thread);
+                if (it != entries.end())
+                {
+                    it->thread = thread;
+                }
+                else
+                {
+                    entries.push_back({thread, std::make_unique<registry_type>(this)});
+                    it = std::prev(entries.end());
+                }
+                ThreadExit::watch(_registries);
+            }
+            cached = {_id, it->registry.get()};
+            return *cached.registry;
+        }
+
+        // Visits every registry, holding the registry list and, on a concurrent layout, the visited registry
+        // locked. fn must not create or destroy nodes.
+        template <typename Fn>
+        void forEachRegistry(Fn&& fn)
+        {
+            const auto visit = [this, &fn](registry_type& registry)
+            {
+                std::unique_lock lock{registry.mutex(), std::defer_lock};
+                if (_concurrent)
+                {
+                    lock.lock();
+                }
+                fn(registry);
+            };
+
+            if (_nodes != nullptr)
+            {
+                visit(*_nodes);
+            }
+            std::lock_guard lock{_registries->mutex};
+            for (auto& entry : _registries->entries)
+            {
+                visit(*entry.registry);
+            }
+        }
+
+        template <typename Fn>
+        void forEachRegistry(Fn&& fn) const
+        {
+            const_cast<Layout*>(this)->forEachRegistry([&fn](registry_type& registry)
+                                                       { fn(static_cast<const registry_type&>(registry)); });
+        }
+
+        static uint64_t nextId() noexcept
+        {
+            static std::atomic<uint64_t> counter{0};
+            return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        struct ThreadRegistry
+        {
+            std::thread::id thread;
+            std::unique_ptr<registry_type> registry;
+        };
+
+        // Registries of a concurrent layout, keyed by the thread creating nodes in them. Shared with the exit
+        // hook of every such thread so that the hook can still reach them, or see they are gone, when it runs.
+        struct ThreadRegistries
+        {
+            std::mutex mutex;
+            std::vector<ThreadRegistry> entries;
+        };
+
+        // Hands the registries of an ending thread back to their layouts, unclaimed, for the next new thread.
+        class ThreadExit
+        {
+        public:
+            static void watch(const std::shared_ptr<ThreadRegistries>& registries)
+            {
+                thread_local ThreadExit exit;
+                std::erase_if(exit._watched, [](const auto& watched) { return watched.expired(); });
+                exit._watched.push_back(registries);
+            }
+
+            ~ThreadExit()
+            {
+                const auto thread = std::this_thread::get_id();
+                for (const auto& watched : _watched)
+                {
+                    if (const auto registries = watched.lock())
+                    {
+                        std::lock_guard lock{registries->mutex};
+                        const auto it = std::ranges::find(registries->entries, thread, &ThreadRegistry::thread);
+                        if (it != registries->entries.end())
+                        {
+                            it->thread = std::thread::id{};
+                        }
+                    }
+                }
+            }
+
+        private:
+            std::vector<std::weak_ptr<ThreadRegistries>> _watched;
+        };
+
+        // A subtree to lay out on its own, with the direction its parent lays it out in.
+        struct Boundary
+        {
+            YGNodeRef node;
+            YGDirection direction;
+        };
+
+        static bool isLayoutBoundary(const YGNodeConstRef node) noexcept
+        {
+            const auto position = YGNodeStyleGetPositionType(node);
+            if (position == YGPositionTypeStatic || YGNodeStyleGetDisplay(node) == YGDisplayNone ||
+                YGNodeStyleGetWidth(node).unit != YGUnitPoint || YGNodeStyleGetHeight(node).unit != YGUnitPoint)
+            {
+                return false;
+            }
+
+            if (position != YGPositionTypeAbsolute)
+            {
+                const auto flex = YGNodeStyleGetFlex(node);
+                const auto basis = YGNodeStyleGetFlexBasis(node).unit;
+                if (flex > 0.f || flex < 0.f || YGNodeStyleGetFlexGrow(node) != 0.f ||
+                    YGNodeStyleGetFlexShrink(node) != 0.f || (basis != YGUnitAuto && basis != YGUnitUndefined))
+                {
+                    return false;
+                }
+            }
+
+            for (const auto& value : {YGNodeStyleGetMinWidth(node), YGNodeStyleGetMinHeight(node),
+                                      YGNodeStyleGetMaxWidth(node), YGNodeStyleGetMaxHeight(node)})
+            {
+                if (value.unit == YGUnitPercent)
+                {
+                    return false;
+                }
+            }
+            for (auto edge = static_cast<int>(YGEdgeLeft); edge <= static_cast<int>(YGEdgeAll); ++edge)
+            {
+                const auto yogaEdge = static_cast<YGEdge>(edge);
+                if (YGNodeStyleGetPadding(node, yogaEdge).unit == YGUnitPercent ||
+                    YGNodeStyleGetMargin(node, yogaEdge).unit == YGUnitPercent ||
+                    YGNodeStyleGetPosition(node, yogaEdge).unit == YGUnitPercent)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Finds the outermost dirty boundaries strictly below root. Clean branches have nothing to lay out.
+        void collectBoundaries(const YGNodeRef root, const YGDirection direction)
+        {
+            _boundaries.clear();
+            _boundaryWalk.clear();
+            _boundaryWalk.push_back({root, direction});
+            while (!_boundaryWalk.empty())
+            {
+                const auto [ygNode, ownerDirection] = _boundaryWalk.back();
+                _boundaryWalk.pop_back();
+                if (!YGNodeIsDirty(ygNode) || YGNodeStyleGetDisplay(ygNode) == YGDisplayNone)
+                {
+                    continue;
+                }
+                if (ygNode != root && isLayoutBoundary(ygNode))
+                {
+                    _boundaries.push_back({ygNode, ownerDirection});
+                    continue;
+                }
+
+                const auto style = YGNodeStyleGetDirection(ygNode);
+                const auto childDirection = style == YGDirectionInherit ? ownerDirection : style;
+                for (auto i = YGNodeGetChildCount(ygNode); i > 0; --i)
+                {
+                    _boundaryWalk.push_back({YGNodeGetChild(ygNode, i - 1), childDirection});
+                }
+            }
+        }
+
+        YGConfigConstRef _config = nullptr;
+        size_t _measureCacheSize = 0;
+        bool _defaultMeasure = false;
+        size_t _recycleLimit = 0;
+        bool _trackDirtied = false;
+        bool _dispatchDirtied = true;
+        std::atomic<bool> _concurrentPhase{false};
+        bool _concurrent = false;
+        uint64_t _id = nextId();
+        std::unique_ptr<registry_type> _nodes = std::make_unique<registry_type>(this);
+        std::shared_ptr<ThreadRegistries> _registries = std::make_shared<ThreadRegistries>();
+        mutable std::mutex _dirtiedMutex;
+        std::vector<node_type> _dirtied;
+        std::vector<node_type> _draining;
+        std::vector<YGNodeRef> _walk;
+        std::vector<Boundary> _boundaries;
+        std::vector<Boundary> _boundaryWalk;
+    };
+
+
+    /**
+     * Layout whose nodes can be created and destroyed from several threads at once.
+     *
+     * Each thread creates nodes in a registry of its own, found through a thread-local cache, so worker threads
+     * building subtrees never wait on each other. Destroying a node locks only the registry that created it.
+     * Recording, draining and clearing dirtied nodes are serialized, and getDirtied() returns a copy. Yoga trees themselves are not synchronized: a subtree must only be
+     * touched by one thread at a time, typically built on a worker and then spliced into the main tree by the
+     * thread that owns it.
+     *
+     * When a thread ends, its registry stays with the layout, nodes included, and is taken over by the next
+     * thread that creates a node, so a stream of short-lived threads does not keep adding registries.
+     */
+    template <typename Ctx>
+    class ConcurrentLayout : public Layout<Ctx>
+    {
+    public:
+        ConcurrentLayout() : Layout<Ctx>{nullptr, true} {}
+
+        /**
+         * Creates a layout whose nodes all use the given configuration.
+         * @param config Configuration shared by every node of this layout; must outlive the layout
+         */
+        explicit ConcurrentLayout(const Config& config) : Layout<Ctx>{config.get(), true} {}
+
+        /**
+         * @return Copy of the nodes dirtied since the list was last drained or cleared, taken while no worker
+         * is appending. Entries may have been destroyed since; check valid() before use.
+         */
+        [[nodiscard]] std::vector<typename Layout<Ctx>::node_type> getDirtied() const
+        {
+            std::scoped_lock lock{this->_dirtiedMutex};
+            return this->_dirtied;
+        }
+    };
 
+    /**
+     * Subtree built apart from any live tree, for example on a loading thread, and later adopted by a Layout.
+     *
+     * Nodes are created in a private layout with the target's configuration, measure cache size and dirtied
+     * tracking, so nothing is shared with the target while building and the subtree may be built on any thread.
+     * Layout::adopt() transfers the whole private storage in one step. A subtree that is never adopted frees
+     * its nodes when destroyed.
+     */
     template <typename Ctx>
-    class Layout
+    class DetachedSubtree
     {
     public:
-        using context_type = Ctx;
+        using layout_type = Layout<Ctx>;
         using node_type = Node<Ctx>;
 
-        Layout() = default;
-        ~Layout()
+        /**
+         * @param target Layout that will adopt the subtree; only its settings are read, on construction
+         * @param args Arguments for the root node's context
+         */
+        template <typename... Args>
+        explicit DetachedSubtree(const layout_type& target, Args&&... args) :
+            _layout{new layout_type{target._config, false}}
         {
-            for (auto& [nodeRef, context] : _nodeContexts)
-            {
-                YGNodeFree(nodeRef);
-            }
-            _nodeContexts.clear();
+            _layout->_measureCacheSize = target._measureCacheSize;
+            _layout->_defaultMeasure = target._defaultMeasure;
+            _layout->_recycleLimit = target._recycleLimit;
+            _layout->_trackDirtied = target._trackDirtied;
+            _root = _layout->createNode(std::forward<Args>(args)...);
         }
 
-        // Pin layout in memory since it's a manager.
-        Layout(const Layout&) = delete;
-        Layout& operator=(const Layout&) = delete;
-        Layout(Layout&&) = delete;
-        Layout& operator=(Layout&&) = delete;
+        DetachedSubtree(DetachedSubtree&&) noexcept = default;
+        DetachedSubtree& operator=(DetachedSubtree&&) noexcept = default;
 
-        template <typename... Args>
-        node_type createNode(Args&&... args)
-        {
-            auto ygNode = YGNodeNew();
-            _nodeContexts.try_emplace(ygNode, std::make_unique<context_type>(std::forward<Args>(args)...));
-            auto node = node_type{this, ygNode};
-            node.setContext(_nodeContexts.at(ygNode).get());
-            return node;
-        }
+        /**
+         * @return Root of the subtree; build below it with Node::createChild and friends
+         */
+        [[nodiscard]] node_type getRoot() const noexcept { return _root; }
 
-        void destroyNode(node_type& node)
+        /**
+         * @return The private layout, to create and destroy nodes of the subtree directly
+         */
+        [[nodiscard]] layout_type& getLayout() noexcept
         {
-            if (node.get() == nullptr)
-                return;
-
-            auto it = _nodeContexts.find(node.get());
-            assert(it != _nodeContexts.end() && "Layout does not contain this node");
-            if (it != _nodeContexts.end())
-            {
-                YGNodeFree(it->first);
-                _nodeContexts.erase(it);
-                node.invalidate();
-            }
+            assert(_layout != nullptr && "Subtree has already been adopted");
+            return *_layout;
         }
 
+        /**
+         * @return Whether the subtree has been adopted by a layout
+         */
+        [[nodiscard]] bool adopted() const noexcept { return _layout == nullptr; }
+
     private:
-        std::unordered_map<YGNodeRef, std::unique_ptr<context_type>> _nodeContexts;
-    };
+        friend class Layout<Ctx>;
 
+        std::unique_ptr<layout_type> _layout;
+        node_type _root;
+    };
 
     template <typename Ctx>
     class Node
@@ -216,17 +1824,22 @@ namespace Yoga
         using layout_type = Layout<Ctx>;
         using context_type = typename layout_type::context_type;
 
-        Node() : _layout{nullptr}, _node{nullptr} {}
+        Node() : _node{nullptr}, _slot{nullptr}, _generation{0} {}
 
         /**
-         * @brief Checks if two Node handles refer to the same underlying Yoga node.
+         * @brief Checks if two Node handles refer to the same node.
          *
-         * This allows Nodes to be used in GTest assertions like EXPECT_EQ.
+         * This allows Nodes to be used in GTest assertions like EXPECT_EQ. Handles are compared by registry slot
+         * and generation rather than by Yoga node, since a recycled Yoga node can belong to a newer node: a
+         * handle to a destroyed node never equals a handle to a live one.
          *
          * @param other The other node handle to compare against.
          * @return True if both handles point to the same node, false otherwise.
          */
-        bool operator==(const Node& other) const noexcept { return get() == other.get(); }
+        bool operator==(const Node& other) const noexcept
+        {
+            return _slot == other._slot && _generation == other._generation;
+        }
 
         /**
          * @brief Checks if two Node handles refer to different underlying Yoga nodes.
@@ -236,21 +1849,43 @@ namespace Yoga
         bool operator!=(const Node& other) const noexcept { return !(*this == other); }
 
 
-        [[nodiscard]] bool valid() const noexcept { return _layout != nullptr && _node != nullptr; }
+        /**
+         * Checks whether this handle still refers to a live node.
+         *
+         * Handles point at their registry slot and remember the generation they were issued with, so every copy
+         * of a handle becomes invalid once its node is destroyed, not only the one passed to Layout::destroyNode.
+         * The check is a single generation compare against the slot, which outlives the node.
+         *
+         * @return True if the node is still owned by its layout
+         */
+        [[nodiscard]] bool valid() const noexcept { return _slot != nullptr && _slot->generation == _generation; }
 
         context_type& getContext() noexcept
         {
             assert_valid();
-            return *static_cast<context_type*>(YGNodeGetContext(_node));
+            return *_slot->context;
         }
 
         const context_type& getContext() const noexcept
         {
             assert_valid();
-            return *static_cast<context_type*>(YGNodeGetContext(_node));
+            return *_slot->context;
+        }
+
+        /**
+         * Replaces the node's context with a new value.
+         *
+         * Contexts live in storage owned by the layout, so the value is moved into it. Earlier versions took a
+         * pointer to caller-owned memory instead, which would now detach the node from its layout.
+         */
+        void setContext(context_type context)
+        {
+            assert_valid();
+            *_slot->context = std::move(context);
         }
 
-        void setContext(context_type* ctxPtr) { YGNodeSetContext(_node, ctxPtr); }
+        // Removed in v3: a pointer would otherwise convert to some contexts, such as bool, and be stored silently.
+        void setContext(context_type*) = delete;
 
         [[nodiscard]] YGNodeRef get() const noexcept { return _node; }
 
@@ -263,7 +1898,7 @@ namespace Yoga
         Node getChild(const size_t index) const
         {
             assert_valid();
-            return Node{_layout, YGNodeGetChild(_node, index)};
+            return Node{YGNodeGetChild(_node, index)};
         }
 
         ChildRange<Node> getChildren()
@@ -275,14 +1910,15 @@ namespace Yoga
         Node getParent()
         {
             assert_valid();
-            return Node{_layout, YGNodeGetParent(_node)};
+            return Node{YGNodeGetParent(_node)};
         }
 
         void insertChild(const Node& child, const size_t index = 0)
         {
             assert_valid();
             child.assert_valid();
-            assert(_layout == child._layout && "Nodes must belong to the same layout");
+            assert(layout() == child.layout() && "Nodes must belong to the same layout");
+            dropDefaultMeasure();
             YGNodeInsertChild(_node, child.get(), index);
         }
 
@@ -297,22 +1933,330 @@ namespace Yoga
         Node createChild(Args&&... args)
         {
             assert_valid();
-            auto child = _layout->createNode(std::forward<Args>(args)...);
+            auto child = layout()->createNode(std::forward<Args>(args)...);
             insertChild(child, getChildCount());
             return child;
         }
 
+        /**
+         * Replaces this node's children in a single reparenting pass.
+         *
+         * Children that are not part of the new list are detached, and the node is dirtied once regardless of
+         * how many children changed.
+         *
+         * @param children The new children, in order
+         */
+        void setChildren(std::span<const Node> children)
+        {
+            assert_valid();
+            std::vector<YGNodeRef> refs;
+            refs.reserve(children.size());
+            for (const auto& child : children)
+            {
+                child.assert_valid();
+                assert(layout() == child.layout() && "Nodes must belong to the same layout");
+                assert((YGNodeGetOwner(child.get()) == nullptr || YGNodeGetOwner(child.get()) == _node) &&
+                       "Child already has an owner, it must be removed first");
+                refs.push_back(child.get());
+            }
+            if (!refs.empty())
+            {
+                dropDefaultMeasure();
+            }
+            YGNodeSetChildren(_node, refs.data(), refs.size());
+        }
+
+        /**
+         * Detaches every child from this node.
+         */
+        void removeAllChildren()
+        {
+            assert_valid();
+            YGNodeRemoveAllChildren(_node);
+        }
+
+        /**
+         * Updates this node's children to match a new list, applying as few changes as possible.
+         *
+         * If the list is unchanged the node is left untouched and is not dirtied. Small edits are applied as
+         * individual removals and insertions; larger ones fall back to a single setChildren() pass, whichever is
+         * cheaper given that each Yoga removal or insertion shifts the child array.
+         *
+         * @param children The new children, in order
+         */
+        void reconcileChildren(std::span<const Node> children)
+        {
+            assert_valid();
+            const auto count = getChildCount();
+            std::vector<YGNodeRef> current;
+            current.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                current.push_back(YGNodeGetChild(_node, i));
+            }
+
+            std::vector<YGNodeRef> next;
+            next.reserve(children.size());
+            for (const auto& child : children)
+            {
+                child.assert_valid();
+                next.push_back(child.get());
+            }
+
+            const auto diff = diffChildren(current, next);
+            if (diff.empty())
+            {
+                return;
+            }
+
+            const auto edits = diff.removals.size() + diff.insertions.size();
+            if (edits * (current.size() + next.size()) >= current.size() * next.size())
+            {
+                setChildren(children);
+                return;
+            }
+
+            for (auto it = diff.removals.rbegin(); it != diff.removals.rend(); ++it)
+            {
+                YGNodeRemoveChild(_node, current[*it]);
+            }
+            for (const auto index : diff.insertions)
+            {
+                insertChild(children[index], index);
+            }
+        }
+
+        /**
+         * Creates a batch of nodes and appends them to this node's children.
+         *
+         * A node without children receives the whole batch through a single YGNodeSetChildren call. Otherwise the
+         * batch is appended one child at a time, which is amortized O(1) per child in Yoga and avoids the
+         * membership scan YGNodeSetChildren performs against existing children.
+         *
+         * @param children Output storage that receives the new handles
+         * @return The filled span
+         */
+        template <typename... Args>
+        std::span<Node> createChildren(std::span<Node> children, const Args&... args)
+        {
+            assert_valid();
+            if (children.empty())
+            {
+                // YGNodeSetChildren would still mark this node dirty.
+                return children;
+            }
+
+            layout()->createNodes(children, args...);
+            dropDefaultMeasure();
+
+            auto index = getChildCount();
+            if (index == 0)
+            {
+                std::vector<YGNodeRef> refs;
+                refs.reserve(children.size());
+                for (const auto& child : children)
+                {
+                    refs.push_back(child.get());
+                }
+                YGNodeSetChildren(_node, refs.data(), refs.size());
+                return children;
+            }
+
+            for (const auto& child : children)
+            {
+                YGNodeInsertChild(_node, child.get(), index++);
+            }
+            return children;
+        }
+
+        /**
+         * Creates count nodes and appends them to this node's children.
+         * @return Handles to the new children, in order
+         */
+        template <typename... Args>
+        std::vector<Node> createChildren(const size_t count, const Args&... args)
+        {
+            std::vector<Node> children(count);
+            createChildren(std::span<Node>{children}, args...);
+            return children;
+        }
+
+        /**
+         * Installs a measure function, turning this node into a leaf whose size comes from its context.
+         *
+         * Yoga calls the function with the available space and how to interpret it. The call is dispatched
+         * through a static trampoline generated for Fn, so installing a measure function does not allocate.
+         * If the layout has a measure cache size set, results are memoized per node (see
+         * Layout::setMeasureCacheSize). Nodes with a measure function cannot have children.
+         *
+         * @param fn Stateless callable taking (Ctx&, width, widthMode, height, heightMode) and returning YGSize
+         */
+        template <typename Fn>
+            requires MeasureFunction<Fn, context_type>
+        void setMeasureFunc([[maybe_unused]] Fn fn)
+        {
+            assert_valid();
+            assert(getChildCount() == 0 && "Nodes with measure functions cannot have children");
+            _slot->defaultMeasure = false;
+            const auto cacheSize = layout()->getMeasureCacheSize();
+            if (cacheSize == 0)
+            {
+                _slot->measureCache.reset();
+            }
+            else if (_slot->measureCache == nullptr || _slot->measureCache->capacity() != cacheSize)
+            {
+                _slot->measureCache = std::make_unique<MeasureCache>(cacheSize);
+            }
+            else
+            {
+                _slot->measureCache->clear();
+            }
+            YGNodeSetMeasureFunc(_node, &measureTrampoline<Fn>);
+        }
+
+        /**
+         * Installs the context's own measure() member as this node's measure function.
+         */
+        void setMeasureFunc()
+            requires Measurable<context_type>
+        {
+            setMeasureFunc([](context_type& ctx, const float width, const YGMeasureMode widthMode, const float height,
+                              const YGMeasureMode heightMode) -> YGSize
+                           { return ctx.measure(width, widthMode, height, heightMode); });
+        }
+
+        /**
+         * Removes the measure function from this node.
+         */
+        void unsetMeasureFunc() noexcept
+        {
+            assert_valid();
+            _slot->defaultMeasure = false;
+            if (_slot->measureCache != nullptr)
+            {
+                _slot->measureCache->clear();
+            }
+            YGNodeSetMeasureFunc(_node, nullptr);
+        }
+
+        /**
+         * @return Whether this node has a measure function
+         */
+        [[nodiscard]] bool hasMeasureFunc() const noexcept
+        {
+            assert_valid();
+            return YGNodeHasMeasureFunc(_node);
+        }
+
+        /**
+         * Installs a baseline function used when this node is aligned with YGAlignBaseline.
+         *
+         * Yoga calls the function with the node's laid out width and height and expects the distance from the
+         * top of the node to its baseline. Dispatch goes through a static trampoline generated for Fn, so
+         * installing a baseline function does not allocate.
+         *
+         * @param fn Stateless callable taking (Ctx&, width, height) and returning the baseline offset
+         */
+        template <typename Fn>
+            requires BaselineFunction<Fn, context_type>
+        void setBaselineFunc([[maybe_unused]] Fn fn) noexcept
+        {
+            assert_valid();
+            YGNodeSetBaselineFunc(_node, &baselineTrampoline<Fn>);
+        }
+
+        /**
+         * Installs the context's own baseline() member as this node's baseline function.
+         */
+        void setBaselineFunc() noexcept
+            requires HasBaseline<context_type>
+        {
+            setBaselineFunc([](context_type& ctx, const float width, const float height) -> float
+                            { return ctx.baseline(width, height); });
+        }
+
+        /**
+         * Removes the baseline function from this node.
+         */
+        void unsetBaselineFunc() noexcept
+        {
+            assert_valid();
+            YGNodeSetBaselineFunc(_node, nullptr);
+        }
+
+        /**
+         * @return Whether this node has a baseline function
+         */
+        [[nodiscard]] bool hasBaselineFunc() const noexcept
+        {
+            assert_valid();
+            return YGNodeHasBaselineFunc(_node);
+        }
+
+        /**
+         * Makes this child the one its parent's baseline is taken from, instead of the first child.
+         * @param isReferenceBaseline Whether this node provides its parent's baseline
+         */
+        void setIsReferenceBaseline(const bool isReferenceBaseline) noexcept
+        {
+            assert_valid();
+            YGNodeSetIsReferenceBaseline(_node, isReferenceBaseline);
+        }
+
+        /**
+         * @return Whether this node provides its parent's baseline
+         */
+        [[nodiscard]] bool isReferenceBaseline() const noexcept
+        {
+            assert_valid();
+            return YGNodeIsReferenceBaseline(_node);
+        }
+
+        /**
+         * Installs a callback invoked whenever this node goes from clean to dirty.
+         *
+         * The callback receives a handle to this node. It runs in addition to layout-wide tracking (see
+         * Layout::setTrackDirtied) and is dispatched through a static trampoline generated for Fn.
+         *
+         * @param fn Stateless callable taking a node handle
+         */
+        template <typename Fn>
+            requires DirtiedFunction<Fn, Node>
+        void setDirtiedFunc([[maybe_unused]] Fn fn) noexcept
+        {
+            assert_valid();
+            YGNodeSetDirtiedFunc(_node, &dirtiedTrampoline<Fn>);
+        }
+
+        /**
+         * Removes this node's dirtied callback. The node is still recorded if its layout tracks dirtied nodes.
+         */
+        void unsetDirtiedFunc() noexcept
+        {
+            assert_valid();
+            YGNodeSetDirtiedFunc(_node, layout()->_trackDirtied ? &dirtiedTrampoline<void> : nullptr);
+        }
+
         /**
          * Resets this node to its original state.
          *
-         * This clears all data including the context pointer.
+         * This clears all style and layout data and any callbacks. The node stays registered with its layout, keeps
+         * its context, remains tracked if its layout tracks dirtied nodes, and gets the layout's default measure
+         * function back if there is one (see Layout::setDefaultMeasure).
          *
          * Use with care.
          */
-        void reset() noexcept
+        void reset()
         {
             assert_valid();
             YGNodeReset(_node);
+            YGNodeSetContext(_node, _slot);
+            if (layout()->_trackDirtied)
+            {
+                YGNodeSetDirtiedFunc(_node, &dirtiedTrampoline<void>);
+            }
+            _slot->defaultMeasure = false;
+            installDefaultMeasure();
         }
 
         /**
@@ -353,10 +2297,16 @@ namespace Yoga
 
         /**
          * Marks a node as requiring a layout recalculation
+         *
+         * Any cached measure results of this node are discarded.
          */
         void markDirty() noexcept
         {
             assert_valid();
+            if (_slot->measureCache != nullptr)
+            {
+                _slot->measureCache->clear();
+            }
             YGNodeMarkDirty(_node);
         }
 
@@ -1314,22 +3264,121 @@ namespace Yoga
 
     private:
         friend class Layout<Ctx>;
+        friend class ChildIterator<Node>;
+
+        using slot_type = typename layout_type::registry_type::Slot;
+
+        // The registry slot is stored as the Yoga node context, so any YGNodeRef owned by a layout can be turned
+        // back into a handle.
+        explicit Node(const YGNodeRef node) :
+            _node{node}, _slot{node != nullptr ? static_cast<slot_type*>(YGNodeGetContext(node)) : nullptr},
+            _generation{_slot != nullptr ? _slot->generation : 0}
+        {
+        }
+
+        // Reads the context through Yoga's node type directly; used on the child iteration fast path.
+        static Node fromChild(facebook::yoga::Node* child) noexcept
+        {
+            Node node;
+            node._node = child;
+            node._slot = static_cast<slot_type*>(child->getContext());
+            node._generation = node._slot->generation;
+            return node;
+        }
+
+        // Installs the context's measure function on a new leaf if its layout measures leaves by default.
+        void installDefaultMeasure()
+        {
+            if constexpr (Measurable<context_type>)
+            {
+                if (layout()->_defaultMeasure)
+                {
+                    setMeasureFunc();
+                    _slot->defaultMeasure = true;
+                }
+            }
+        }
+
+        // Yoga does not measure nodes with children, so a default measure function goes before a child is added.
+        void dropDefaultMeasure() noexcept
+        {
+            if (_slot->defaultMeasure)
+            {
+                unsetMeasureFunc();
+            }
+        }
+
+        // The layout is reached through the registry so that handles follow a registry adopted by another layout.
+        [[nodiscard]] layout_type* layout() const noexcept { return _slot->registry->owner(); }
+
+        [[nodiscard]] static slot_type& slotOf(const YGNodeConstRef node) noexcept
+        {
+            return *static_cast<slot_type*>(YGNodeGetContext(node));
+        }
+
+        template <typename Fn>
+        static YGSize measureTrampoline(const YGNodeConstRef node, const float width, const YGMeasureMode widthMode,
+                                        const float height, const YGMeasureMode heightMode)
+        {
+            auto& slot = slotOf(node);
+            if (slot.measureCache == nullptr)
+            {
+                return Fn{}(*slot.context, width, widthMode, height, heightMode);
+            }
 
-        Node(layout_type* layout, const YGNodeRef node) : _layout{layout}, _node{node}
+            if (const auto* cached = slot.measureCache->find(width, widthMode, height, heightMode))
+            {
+                return *cached;
+            }
+
+            const YGSize size = Fn{}(*slot.context, width, widthMode, height, heightMode);
+            slot.measureCache->store(width, widthMode, height, heightMode, size);
+            return size;
+        }
+
+        template <typename Fn>
+        static float baselineTrampoline(const YGNodeConstRef node, const float width, const float height)
+        {
+            return Fn{}(*slotOf(node).context, width, height);
+        }
+
+        // Fn is void when the node is only being tracked by its layout.
+        template <typename Fn>
+        static void dirtiedTrampoline(const YGNodeConstRef node)
         {
-            assert(layout != nullptr && "Layout must not be null");
+            auto* layout = slotOf(node).registry->owner();
+            if (!layout->_dispatchDirtied)
+            {
+                return;
+            }
+
+            const Node handle{const_cast<YGNodeRef>(node)};
+            if (layout->_trackDirtied)
+            {
+                std::unique_lock lock{layout->_dirtiedMutex, std::defer_lock};
+                if (layout->_concurrent)
+                {
+                    lock.lock();
+                }
+                layout->_dirtied.push_back(handle);
+            }
+            if constexpr (!std::is_void_v<Fn>)
+            {
+                Fn{}(handle);
+            }
         }
 
         // Allows Layout to invalidate a handle after destruction.
         void invalidate()
         {
-            _layout = nullptr;
             _node = nullptr;
+            _slot = nullptr;
         }
 
         void assert_valid() const { assert(valid() && "Node handle is invalid"); }
 
-        layout_type* _layout;
         YGNodeRef _node;
+        slot_type* _slot;
+        uint32_t _generation;
     };
 } // namespace Yoga
@@ -0,0 +1,115 @@
+#include "yoga-cpp/hit_tester.hpp"
+
+#include <bit>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// Vector kernels are compiled into this file only, so the instruction set flags of code including the header
+// cannot give the HitTester class different definitions in different translation units.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define YOGACPP_HIT_TEST_SSE2 1
+#endif
+
+#if defined(__AVX__)
+#define YOGACPP_HIT_TEST_AVX 1
+#define YOGACPP_TARGET_AVX
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define YOGACPP_HIT_TEST_AVX 1
+#define YOGACPP_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+namespace Yoga
+{
+    namespace
+    {
+        using Kernel = size_t (*)(const float*, const float*, const float*, const float*, size_t, float,
+                                  float) noexcept;
+
+#if !defined(YOGACPP_HIT_TEST_SSE2)
+        size_t findScalar(const float* left, const float* top, const float* right, const float* bottom,
+                          const size_t count, const float x, const float y) noexcept
+        {
+            for (auto i = count; i > 0; --i)
+            {
+                if (x >= left[i - 1] && x < right[i - 1] && y >= top[i - 1] && y < bottom[i - 1])
+                {
+                    return i - 1;
+                }
+            }
+            return count;
+        }
+#else
+        size_t findSse2(const float* left, const float* top, const float* right, const float* bottom,
+                        const size_t count, const float x, const float y) noexcept
+        {
+            const __m128 px = _mm_set1_ps(x);
+            const __m128 py = _mm_set1_ps(y);
+            for (auto block = count; block > 0; block -= 4)
+            {
+                const auto first = block - 4;
+                const __m128 inX = _mm_and_ps(_mm_cmpge_ps(px, _mm_loadu_ps(left + first)),
+                                              _mm_cmplt_ps(px, _mm_loadu_ps(right + first)));
+                const __m128 inY = _mm_and_ps(_mm_cmpge_ps(py, _mm_loadu_ps(top + first)),
+                                              _mm_cmplt_ps(py, _mm_loadu_ps(bottom + first)));
+                if (const auto mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(inX, inY))); mask != 0)
+                {
+                    return first + static_cast<size_t>(std::bit_width(mask)) - 1;
+                }
+            }
+            return count;
+        }
+#endif
+
+#if defined(YOGACPP_HIT_TEST_AVX)
+        YOGACPP_TARGET_AVX size_t findAvx(const float* left, const float* top, const float* right,
+                                          const float* bottom, const size_t count, const float x,
+                                          const float y) noexcept
+        {
+            const __m256 px = _mm256_set1_ps(x);
+            const __m256 py = _mm256_set1_ps(y);
+            for (auto block = count; block > 0; block -= 8)
+            {
+                const auto first = block - 8;
+                const __m256 inX = _mm256_and_ps(_mm256_cmp_ps(px, _mm256_loadu_ps(left + first), _CMP_GE_OQ),
+                                                 _mm256_cmp_ps(px, _mm256_loadu_ps(right + first), _CMP_LT_OQ));
+                const __m256 inY = _mm256_and_ps(_mm256_cmp_ps(py, _mm256_loadu_ps(top + first), _CMP_GE_OQ),
+                                                 _mm256_cmp_ps(py, _mm256_loadu_ps(bottom + first), _CMP_LT_OQ));
+                if (const auto mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(inX, inY)));
+                    mask != 0)
+                {
+                    return first + static_cast<size_t>(std::bit_width(mask)) - 1;
+                }
+            }
+            return count;
+        }
+#endif
+
+        // Every kernel steps through a whole number of blocks, as HitTester pads to a multiple of 8.
+        Kernel selectKernel() noexcept
+        {
+#if defined(__AVX__)
+            return &findAvx;
+#elif defined(YOGACPP_HIT_TEST_AVX)
+            if (__builtin_cpu_supports("avx"))
+            {
+                return &findAvx;
+            }
+#endif
+#if defined(YOGACPP_HIT_TEST_SSE2)
+            return &findSse2;
+#else
+            return &findScalar;
+#endif
+        }
+    } // namespace
+
+    size_t findLastContaining(const float* left, const float* top, const float* right, const float* bottom,
+                              const size_t count, const float x, const float y) noexcept
+    {
+        static const Kernel kernel = selectKernel();
+        return kernel(left, top, right, bottom, count, x, y);
+    }
+} // namespace Yoga
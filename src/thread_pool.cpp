@@ -0,0 +1,151 @@
+#include "yoga-cpp/thread_pool.hpp"
+
+#include <utility>
+
+namespace Yoga
+{
+    namespace
+    {
+        // Pool whose loop the current thread is running, to keep nested loops from waiting on themselves.
+        thread_local const ThreadPool* tCurrentPool = nullptr;
+
+        // Marks the current thread as running a pool's loop until the scope ends, even if it ends by throwing.
+        class CurrentPoolScope
+        {
+        public:
+            explicit CurrentPoolScope(const ThreadPool* pool) noexcept : _previous{std::exchange(tCurrentPool, pool)}
+            {
+            }
+
+            ~CurrentPoolScope() { tCurrentPool = _previous; }
+
+            CurrentPoolScope(const CurrentPoolScope&) = delete;
+            CurrentPoolScope& operator=(const CurrentPoolScope&) = delete;
+
+        private:
+            const ThreadPool* _previous;
+        };
+    } // namespace
+
+    ThreadPool::ThreadPool(const size_t threadCount)
+    {
+        const size_t workers = threadCount > 1 ? threadCount - 1 : 0;
+        _workers.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+        {
+            _workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock{_mutex};
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    size_t ThreadPool::defaultThreadCount() noexcept
+    {
+        const auto concurrency = std::thread::hardware_concurrency();
+        return concurrency > 0 ? concurrency : 1;
+    }
+
+    void ThreadPool::dispatch(const size_t count, const Task task, void* state)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (_workers.empty() || count == 1 || tCurrentPool == this)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                task(state, i);
+            }
+            return;
+        }
+
+        std::lock_guard submit{_submit};
+        {
+            std::lock_guard lock{_mutex};
+            _task = task;
+            _state = state;
+            _count = count;
+            _next.store(0, std::memory_order_relaxed);
+            _active = _workers.size();
+            _error = nullptr;
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        {
+            const CurrentPoolScope scope{this};
+            work();
+        }
+
+        // Workers may still be running the task, so its state has to outlive them even when rethrowing.
+        std::exception_ptr error;
+        {
+            std::unique_lock lock{_mutex};
+            _done.wait(lock, [this] { return _active == 0; });
+            error = std::exchange(_error, nullptr);
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void ThreadPool::work() noexcept
+    {
+        try
+        {
+            for (auto index = _next.fetch_add(1, std::memory_order_relaxed); index < _count;
+                 index = _next.fetch_add(1, std::memory_order_relaxed))
+            {
+                _task(_state, index);
+            }
+        }
+        catch (...)
+        {
+            // Skip the indices nobody has taken yet and keep the first error for dispatch() to rethrow.
+            _next.store(_count, std::memory_order_relaxed);
+            std::lock_guard lock{_mutex};
+            if (!_error)
+            {
+                _error = std::current_exception();
+            }
+        }
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        const CurrentPoolScope scope{this};
+        uint64_t seen = 0;
+        std::unique_lock lock{_mutex};
+        while (true)
+        {
+            _wake.wait(lock, [&] { return _stop || _generation != seen; });
+            if (_stop)
+            {
+                return;
+            }
+            seen = _generation;
+
+            lock.unlock();
+            work();
+            lock.lock();
+
+            if (--_active == 0)
+            {
+                _done.notify_one();
+            }
+        }
+    }
+} // namespace Yoga
@@ -1 +1,80 @@
 #include "yoga-cpp/yoga.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace Yoga
+{
+    ChildrenDiff diffChildren(const std::span<const YGNodeRef> current, const std::span<const YGNodeRef> next)
+    {
+        constexpr auto missing = static_cast<size_t>(-1);
+
+        std::unordered_map<YGNodeRef, size_t> oldIndices;
+        oldIndices.reserve(current.size());
+        for (size_t i = 0; i < current.size(); ++i)
+        {
+            oldIndices.emplace(current[i], i);
+        }
+
+        // Old position of every target child, or missing if it is new.
+        std::vector<size_t> sources(next.size(), missing);
+        for (size_t i = 0; i < next.size(); ++i)
+        {
+            if (const auto it = oldIndices.find(next[i]); it != oldIndices.end())
+            {
+                sources[i] = it->second;
+            }
+        }
+
+        // Longest increasing run of old positions; those children keep their place.
+        std::vector<size_t> tails;
+        std::vector<size_t> previous(next.size(), missing);
+        for (size_t i = 0; i < next.size(); ++i)
+        {
+            if (sources[i] == missing)
+            {
+                continue;
+            }
+
+            const auto pos =
+                std::ranges::lower_bound(tails, sources[i], {}, [&](const size_t tail) { return sources[tail]; });
+            if (pos != tails.begin())
+            {
+                previous[i] = *(pos - 1);
+            }
+            if (pos == tails.end())
+            {
+                tails.push_back(i);
+            }
+            else
+            {
+                *pos = i;
+            }
+        }
+
+        std::vector<bool> keptNew(next.size(), false);
+        std::vector<bool> keptOld(current.size(), false);
+        for (auto i = tails.empty() ? missing : tails.back(); i != missing; i = previous[i])
+        {
+            keptNew[i] = true;
+            keptOld[sources[i]] = true;
+        }
+
+        ChildrenDiff diff;
+        for (size_t i = 0; i < current.size(); ++i)
+        {
+            if (!keptOld[i])
+            {
+                diff.removals.push_back(i);
+            }
+        }
+        for (size_t i = 0; i < next.size(); ++i)
+        {
+            if (!keptNew[i])
+            {
+                diff.insertions.push_back(i);
+            }
+        }
+        return diff;
+    }
+} // namespace Yoga
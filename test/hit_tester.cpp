@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <random>
+
+#include "yoga-cpp/hit_tester.hpp"
+
+using HitLayout = Yoga::Layout<int>;
+using HitNode = Yoga::Node<int>;
+
+TEST(HitTesterTest, ReturnsTopmostNode) {
+    HitLayout layout;
+    HitNode root = layout.createNode(0);
+    root.setWidth(200.f);
+    root.setHeight(200.f);
+
+    HitNode panel = root.createChild(1);
+    panel.setPositionType(YGPositionTypeAbsolute);
+    panel.setPosition(YGEdgeLeft, 10.f);
+    panel.setPosition(YGEdgeTop, 10.f);
+    panel.setWidth(100.f);
+    panel.setHeight(100.f);
+
+    HitNode button = panel.createChild(2);
+    button.setPositionType(YGPositionTypeAbsolute);
+    button.setPosition(YGEdgeLeft, 20.f);
+    button.setPosition(YGEdgeTop, 20.f);
+    button.setWidth(30.f);
+    button.setHeight(30.f);
+
+    root.calculateLayout(200.f, 200.f);
+
+    Yoga::LayoutSnapshot<int> snapshot;
+    snapshot.capture(root);
+    Yoga::HitTester<int> tester{snapshot};
+
+    EXPECT_EQ(tester.hitTest(35.f, 35.f), button);
+    EXPECT_EQ(tester.hitTest(30.f, 30.f), button);
+    EXPECT_EQ(tester.hitTest(60.f, 60.f), panel);
+    EXPECT_EQ(tester.hitTest(150.f, 150.f), root);
+    EXPECT_FALSE(tester.hitTest(250.f, 10.f).valid());
+}
+
+TEST(HitTesterTest, MatchesScalarScan) {
+    HitLayout layout;
+    HitNode root = layout.createNode(0);
+    root.setWidth(1000.f);
+    root.setHeight(1000.f);
+
+    std::mt19937 random{42};
+    std::uniform_real_distribution<float> coordinate{0.f, 900.f};
+    std::uniform_real_distribution<float> extent{1.f, 100.f};
+    for (int i = 1; i < 203; ++i) {
+        HitNode child = root.createChild(i);
+        child.setPositionType(YGPositionTypeAbsolute);
+        child.setPosition(YGEdgeLeft, coordinate(random));
+        child.setPosition(YGEdgeTop, coordinate(random));
+        child.setWidth(extent(random));
+        child.setHeight(extent(random));
+    }
+    root.calculateLayout(1000.f, 1000.f);
+
+    Yoga::LayoutSnapshot<int> snapshot;
+    snapshot.capture(root);
+    Yoga::HitTester<int> tester{snapshot};
+    ASSERT_EQ(tester.size(), snapshot.size());
+
+    std::uniform_real_distribution<float> point{-10.f, 1010.f};
+    for (int query = 0; query < 1000; ++query) {
+        const float x = point(random);
+        const float y = point(random);
+
+        auto expected = Yoga::HitTester<int>::npos;
+        for (size_t i = snapshot.size(); i > 0; --i) {
+            const auto index = i - 1;
+            if (x >= snapshot.x()[index] && x < snapshot.x()[index] + snapshot.width()[index] &&
+                y >= snapshot.y()[index] && y < snapshot.y()[index] + snapshot.height()[index]) {
+                expected = index;
+                break;
+            }
+        }
+        EXPECT_EQ(tester.hitIndex(x, y), expected);
+    }
+}
@@ -1,8 +1,12 @@
+#include <chrono>
+#include <atomic>
 #include <gtest/gtest.h>
 #include <memory>
 #include <vector>
 #include <string>
+#include <thread>
 
+#include "yoga-cpp/thread_pool.hpp"
 #include "yoga-cpp/yoga.hpp"
 
 struct TestContext {
@@ -141,3 +145,951 @@ TEST_F(LayoutCalculationTest, SimpleFlexLayout) {
     EXPECT_FLOAT_EQ(child2.getLayoutWidth(), 250.f);
     EXPECT_FLOAT_EQ(child2.getLayoutHeight(), 100.f);
 }
+
+TEST_F(LayoutLifetimeTest, SetContextReplacesValue) {
+    TestNode node = layout.createNode(1, "before");
+    const TestContext* storage = &node.getContext();
+
+    node.setContext({2, "after"});
+    EXPECT_EQ(&node.getContext(), storage);
+    EXPECT_EQ(node.getContext().id, 2);
+    EXPECT_EQ(node.getContext().name, "after");
+}
+
+template <typename Ctx>
+concept TakesContextPointer = requires(Yoga::Node<Ctx> node, Ctx* context) { node.setContext(context); };
+
+// The v2 pointer overload must not come back as a silent conversion, e.g. pointer to bool.
+static_assert(!TakesContextPointer<bool>);
+static_assert(!TakesContextPointer<TestContext>);
+
+TEST_F(LayoutLifetimeTest, DestroyedContextSlotIsReused) {
+    TestNode first = layout.createNode(1, "First");
+    TestNode second = layout.createNode(2, "Second");
+    TestContext* firstContext = &first.getContext();
+
+    layout.destroyNode(first);
+    TestNode third = layout.createNode(3, "Third");
+
+    EXPECT_EQ(&third.getContext(), firstContext);
+    EXPECT_EQ(third.getContext().id, 3);
+    EXPECT_EQ(second.getContext().name, "Second");
+}
+
+TEST(ContextPoolTest, AddressesStayStableAcrossChunks) {
+    Yoga::ContextPool<TestContext, 4> pool;
+    std::vector<TestContext*> contexts;
+    for (int i = 0; i < 10; ++i) {
+        contexts.push_back(pool.create(i, "Context"));
+    }
+
+    EXPECT_EQ(pool.size(), 10u);
+    EXPECT_EQ(pool.capacity(), 12u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(contexts[i]->id, i);
+    }
+
+    for (auto* context : contexts) {
+        pool.destroy(context);
+    }
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+TEST_F(LayoutLifetimeTest, DestroyInvalidatesEveryCopy) {
+    TestNode node = layout.createNode(1, "Node");
+    TestNode copy = node;
+    EXPECT_EQ(layout.size(), 1u);
+
+    layout.destroyNode(node);
+    EXPECT_FALSE(node.valid());
+    EXPECT_FALSE(copy.valid());
+    EXPECT_EQ(layout.size(), 0u);
+
+    // The slot is reused, but the stale copy must not resolve to the new node.
+    TestNode replacement = layout.createNode(2, "Replacement");
+    EXPECT_TRUE(replacement.valid());
+    EXPECT_FALSE(copy.valid());
+}
+
+TEST_F(LayoutLifetimeTest, ResetKeepsContext) {
+    TestNode node = layout.createNode(7, "Reset");
+    node.setWidth(10.f);
+
+    node.reset();
+
+    EXPECT_TRUE(node.valid());
+    EXPECT_EQ(node.getContext().id, 7);
+}
+
+TEST_F(NodeChildManagementTest, HandlesFromTraversalTrackDestruction) {
+    TestNode child = parent.createChild(2, "Child");
+    TestNode fromParent = parent.getChild(0);
+    TestNode fromIteration = *parent.getChildren().begin();
+
+    layout.destroyNode(fromParent);
+
+    EXPECT_FALSE(child.valid());
+    EXPECT_FALSE(fromIteration.valid());
+    EXPECT_EQ(parent.getChildCount(), 0);
+    EXPECT_TRUE(parent.valid());
+}
+
+TEST_F(LayoutLifetimeTest, CreateNodesInBulk) {
+    auto nodes = layout.createNodes(100, 5, "Row");
+
+    ASSERT_EQ(nodes.size(), 100u);
+    EXPECT_EQ(layout.size(), 100u);
+    for (auto& node : nodes) {
+        EXPECT_TRUE(node.valid());
+        EXPECT_EQ(node.getContext().id, 5);
+        EXPECT_EQ(node.getContext().name, "Row");
+    }
+    EXPECT_NE(&nodes[0].getContext(), &nodes[1].getContext());
+}
+
+TEST_F(NodeChildManagementTest, CreateChildrenAppendsInOrder) {
+    TestNode first = parent.createChild(1, "First");
+
+    std::vector<TestNode> batch(3);
+    parent.createChildren(std::span<TestNode>{batch}, 2, "Batch");
+
+    ASSERT_EQ(parent.getChildCount(), 4);
+    EXPECT_EQ(parent.getChild(0), first);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        EXPECT_EQ(parent.getChild(i + 1), batch[i]);
+        EXPECT_EQ(batch[i].getParent(), parent);
+    }
+
+    TestNode empty = layout.createNode();
+    auto children = empty.createChildren(5);
+    ASSERT_EQ(empty.getChildCount(), 5);
+    EXPECT_EQ(empty.getChild(4), children[4]);
+}
+
+TEST_F(NodeChildManagementTest, CreateChildrenWithEmptyBatchLeavesParentClean) {
+    TestNode leaf = layout.createNode();
+    leaf.calculateLayout(10.f, 10.f);
+    ASSERT_FALSE(leaf.isDirty());
+
+    EXPECT_TRUE(leaf.createChildren(0).empty());
+    EXPECT_FALSE(leaf.isDirty());
+}
+
+TEST_F(NodeChildManagementTest, SetAndRemoveAllChildren) {
+    auto children = layout.createNodes(3);
+    parent.setChildren(children);
+
+    ASSERT_EQ(parent.getChildCount(), 3);
+    EXPECT_EQ(parent.getChild(2), children[2]);
+
+    std::vector<TestNode> reordered{children[2], children[0]};
+    parent.setChildren(reordered);
+    ASSERT_EQ(parent.getChildCount(), 2);
+    EXPECT_EQ(parent.getChild(0), children[2]);
+    EXPECT_EQ(parent.getChild(1), children[0]);
+    EXPECT_FALSE(children[1].getParent().valid());
+
+    parent.removeAllChildren();
+    EXPECT_EQ(parent.getChildCount(), 0);
+    EXPECT_FALSE(children[0].getParent().valid());
+}
+
+TEST(ChildrenDiffTest, KeepsLongestOrderedRun) {
+    std::vector<YGNodeRef> nodes;
+    for (int i = 0; i < 5; ++i) {
+        nodes.push_back(YGNodeNew());
+    }
+
+    // a b c d -> b c a e : b and c stay, a moves, d is removed, e is inserted
+    std::vector<YGNodeRef> current{nodes[0], nodes[1], nodes[2], nodes[3]};
+    std::vector<YGNodeRef> next{nodes[1], nodes[2], nodes[0], nodes[4]};
+    auto diff = Yoga::diffChildren(current, next);
+    EXPECT_EQ(diff.removals, (std::vector<size_t>{0, 3}));
+    EXPECT_EQ(diff.insertions, (std::vector<size_t>{2, 3}));
+
+    EXPECT_TRUE(Yoga::diffChildren(current, current).empty());
+
+    for (auto node : nodes) {
+        YGNodeFree(node);
+    }
+}
+
+TEST_F(NodeChildManagementTest, ReconcileChildrenAppliesMinimalEdits) {
+    auto children = layout.createNodes(6);
+    parent.setChildren(children);
+    parent.calculateLayout(100.f, 100.f);
+    ASSERT_FALSE(parent.isDirty());
+
+    parent.reconcileChildren(children);
+    EXPECT_FALSE(parent.isDirty());
+
+    std::vector<TestNode> next{children[0], children[2], children[1], children[3], children[4], children[5]};
+    parent.reconcileChildren(next);
+    EXPECT_TRUE(parent.isDirty());
+    ASSERT_EQ(parent.getChildCount(), next.size());
+    for (size_t i = 0; i < next.size(); ++i) {
+        EXPECT_EQ(parent.getChild(i), next[i]);
+    }
+}
+
+TEST(ConfigTest, LayoutCreatesNodesWithConfig) {
+    Yoga::Config config;
+    config.setPointScaleFactor(0.f);
+    EXPECT_FLOAT_EQ(config.getPointScaleFactor(), 0.f);
+
+    TestLayout configured{config};
+    TestNode node = configured.createNode();
+
+    EXPECT_EQ(configured.getConfig(), config.get());
+    EXPECT_EQ(YGNodeGetConfig(node.get()), config.get());
+}
+
+struct TextContext {
+    float glyphs = 0;
+    int measureCalls = 0;
+
+    TextContext() = default;
+    explicit TextContext(float glyphs) : glyphs(glyphs) {}
+
+    YGSize measure(float, YGMeasureMode, float, YGMeasureMode) {
+        ++measureCalls;
+        return {glyphs * 10.f, 20.f};
+    }
+};
+
+TEST(MeasureFuncTest, MeasurableContextSizesLeaf) {
+    Yoga::Layout<TextContext> layout;
+    auto root = layout.createNode();
+    root.setWidth(500.f);
+    root.setHeight(500.f);
+
+    auto text = root.createChild(4.f);
+    text.setMeasureFunc();
+    EXPECT_TRUE(text.hasMeasureFunc());
+
+    root.calculateLayout(500.f, 500.f);
+    EXPECT_GT(text.getContext().measureCalls, 0);
+    EXPECT_FLOAT_EQ(text.getLayoutHeight(), 20.f);
+
+    text.unsetMeasureFunc();
+    EXPECT_FALSE(text.hasMeasureFunc());
+}
+
+TEST(MeasureFuncTest, LayoutDefaultMeasuresLeaves) {
+    Yoga::Layout<TextContext> layout;
+    layout.setDefaultMeasure(true);
+
+    auto root = layout.createNode();
+    EXPECT_TRUE(root.hasMeasureFunc());
+    root.setWidth(500.f);
+    root.setHeight(500.f);
+
+    // Gaining a child turns the root into a container.
+    auto text = root.createChild(4.f);
+    EXPECT_FALSE(root.hasMeasureFunc());
+    EXPECT_TRUE(text.hasMeasureFunc());
+
+    auto icon = root.createChild(1.f);
+    icon.unsetMeasureFunc();
+    icon.setWidth(16.f);
+    icon.setHeight(16.f);
+
+    root.calculateLayout(500.f, 500.f);
+    EXPECT_GT(text.getContext().measureCalls, 0);
+    EXPECT_EQ(icon.getContext().measureCalls, 0);
+    EXPECT_EQ(root.getContext().measureCalls, 0);
+
+    // An explicit choice survives; the default comes back only through reset().
+    root.removeAllChildren();
+    EXPECT_FALSE(root.hasMeasureFunc());
+    icon.reset();
+    EXPECT_TRUE(icon.hasMeasureFunc());
+
+    layout.setDefaultMeasure(false);
+    EXPECT_FALSE(layout.createNode().hasMeasureFunc());
+}
+
+TEST(MeasureFuncTest, StatelessLambdaReceivesContext) {
+    TestLayout layout;
+    auto root = layout.createNode();
+    root.setFlexDirection(YGFlexDirectionRow);
+    root.setWidth(500.f);
+    root.setHeight(100.f);
+
+    auto label = root.createChild(12, "Label");
+    label.setMeasureFunc([](TestContext& ctx, float, YGMeasureMode, float, YGMeasureMode) -> YGSize {
+        return {static_cast<float>(ctx.id), 10.f};
+    });
+
+    root.calculateLayout(500.f, 100.f);
+    EXPECT_FLOAT_EQ(label.getLayoutWidth(), 12.f);
+}
+
+TEST(MeasureFuncTest, CacheAnswersRepeatedConstraintsUntilDirty) {
+    // Yoga never remeasures a clean leaf by itself; the wrapper cache covers a leaf dirtied by a style change
+    // that leaves its measure constraints as they were.
+    auto remeasuresAfterMarginChange = [](size_t cacheSize) {
+        Yoga::Layout<TextContext> layout;
+        layout.setMeasureCacheSize(cacheSize);
+
+        auto root = layout.createNode();
+        root.setWidth(300.f);
+        root.setHeight(300.f);
+        auto text = root.createChild(3.f);
+        text.setMeasureFunc();
+
+        root.calculateLayout(300.f, 300.f);
+        const int firstPass = text.getContext().measureCalls;
+        EXPECT_GT(firstPass, 0);
+
+        text.setMargin(YGEdgeTop, 5.f);
+        root.calculateLayout(300.f, 300.f);
+        const int remeasures = text.getContext().measureCalls - firstPass;
+
+        // New content is measured again once the node is marked dirty.
+        text.getContext().glyphs = 5.f;
+        text.markDirty();
+        root.calculateLayout(300.f, 300.f);
+        EXPECT_GT(text.getContext().measureCalls, firstPass + remeasures);
+        return remeasures;
+    };
+
+    EXPECT_EQ(remeasuresAfterMarginChange(4), 0);
+    EXPECT_GT(remeasuresAfterMarginChange(0), 0);
+}
+
+TEST(MeasureCacheTest, EvictsOldestEntry) {
+    Yoga::MeasureCache cache{2};
+    cache.store(10.f, YGMeasureModeExactly, YGUndefined, YGMeasureModeUndefined, {10.f, 1.f});
+    cache.store(20.f, YGMeasureModeExactly, YGUndefined, YGMeasureModeUndefined, {20.f, 1.f});
+
+    ASSERT_NE(cache.find(10.f, YGMeasureModeExactly, YGUndefined, YGMeasureModeUndefined), nullptr);
+    EXPECT_EQ(cache.find(10.f, YGMeasureModeAtMost, YGUndefined, YGMeasureModeUndefined), nullptr);
+
+    cache.store(30.f, YGMeasureModeExactly, YGUndefined, YGMeasureModeUndefined, {30.f, 1.f});
+    EXPECT_EQ(cache.find(10.f, YGMeasureModeExactly, YGUndefined, YGMeasureModeUndefined), nullptr);
+    EXPECT_FLOAT_EQ(cache.find(30.f, YGMeasureModeExactly, 5.f, YGMeasureModeUndefined)->width, 30.f);
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+struct GlyphRun {
+    float ascent = 0;
+
+    GlyphRun() = default;
+    explicit GlyphRun(float ascent) : ascent(ascent) {}
+
+    float baseline(float, float) const { return ascent; }
+};
+
+TEST(BaselineFuncTest, RowAlignsChildrenOnContextBaseline) {
+    Yoga::Layout<GlyphRun> layout;
+    auto row = layout.createNode();
+    row.setFlexDirection(YGFlexDirectionRow);
+    row.setAlignItems(YGAlignBaseline);
+    row.setWidth(200.f);
+    row.setHeight(100.f);
+
+    auto large = row.createChild(30.f);
+    large.setWidth(50.f);
+    large.setHeight(40.f);
+    large.setBaselineFunc();
+
+    auto small = row.createChild(10.f);
+    small.setWidth(50.f);
+    small.setHeight(20.f);
+    small.setBaselineFunc([](GlyphRun& run, float, float) { return run.ascent; });
+
+    EXPECT_TRUE(large.hasBaselineFunc());
+    row.calculateLayout(200.f, 100.f);
+
+    EXPECT_FLOAT_EQ(large.getLayoutTop(), 0.f);
+    EXPECT_FLOAT_EQ(small.getLayoutTop(), 20.f);
+
+    small.unsetBaselineFunc();
+    EXPECT_FALSE(small.hasBaselineFunc());
+}
+
+struct DirtiedCounter {
+    static inline int calls = 0;
+    void operator()(TestNode node) const {
+        ++calls;
+        EXPECT_TRUE(node.valid());
+    }
+};
+
+TEST(DirtiedTest, LayoutRecordsNodesDirtiedByPropagation) {
+    Yoga::Layout<TextContext> layout;
+    layout.setTrackDirtied(true);
+
+    auto root = layout.createNode();
+    auto column = root.createChild();
+    auto text = column.createChild(2.f);
+    text.setMeasureFunc();
+    root.calculateLayout(100.f, 100.f);
+    layout.clearDirtied();
+
+    text.markDirty();
+
+    std::vector<Yoga::Node<TextContext>> drained;
+    layout.drainDirtied([&](auto node) { drained.push_back(node); });
+    EXPECT_EQ(drained, (std::vector<Yoga::Node<TextContext>>{text, column, root}));
+    EXPECT_TRUE(layout.getDirtied().empty());
+}
+
+TEST(DirtiedTest, NodeCallbackRunsAlongsideTracking) {
+    TestLayout layout;
+    auto root = layout.createNode();
+    auto child = root.createChild();
+    root.calculateLayout(100.f, 100.f);
+
+    DirtiedCounter::calls = 0;
+    root.setDirtiedFunc(DirtiedCounter{});
+    layout.setTrackDirtied(true);
+
+    root.removeChild(child);
+    EXPECT_EQ(DirtiedCounter::calls, 1);
+    ASSERT_EQ(layout.getDirtied().size(), 1u);
+    EXPECT_EQ(layout.getDirtied()[0], root);
+
+    layout.setTrackDirtied(false);
+    EXPECT_NE(YGNodeGetDirtiedFunc(root.get()), nullptr);
+    EXPECT_EQ(YGNodeGetDirtiedFunc(child.get()), nullptr);
+}
+
+TEST_F(LayoutCalculationTest, CollectUpdatedSkipsUnchangedBranches) {
+    TestNode root = layout.createNode();
+    root.setFlexDirection(YGFlexDirectionRow);
+    TestNode left = root.createChild(1, "Left");
+    left.setWidth(100.f);
+    TestNode right = root.createChild(2, "Right");
+    right.setFlexGrow(1.f);
+    TestNode leaf = left.createChild(3, "Leaf");
+
+    root.calculateLayout(400.f, 100.f);
+
+    std::vector<TestLayout::record_type> records;
+    layout.collectUpdated(root, std::back_inserter(records));
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records[0].node, root);
+    EXPECT_EQ(records[1].node, left);
+    EXPECT_EQ(records[2].node, leaf);
+    EXPECT_EQ(records[3].node, right);
+    EXPECT_FLOAT_EQ(records[3].left, 100.f);
+    EXPECT_FLOAT_EQ(records[3].width, 300.f);
+    EXPECT_FALSE(root.hasNewLayout());
+
+    // Nothing was laid out again, so nothing is reported.
+    records.clear();
+    layout.collectUpdated(root, std::back_inserter(records));
+    EXPECT_TRUE(records.empty());
+
+    // A flag left on a node below an unflagged parent is not reached.
+    leaf.setHasNewLayout(true);
+    layout.collectUpdated(root, std::back_inserter(records));
+    EXPECT_TRUE(records.empty());
+}
+
+// Lays out the same panel strip serially and in parallel with the given config and compares every node.
+static void expectParallelMatchesSerial(const Yoga::Config& config, const float offset, const float panelWidth,
+                                        const float rowHeight, const float marginPercent = 0.f) {
+    auto build = [&](TestLayout& layout) {
+        TestNode root = layout.createNode(0, "root");
+        root.setFlexDirection(YGFlexDirectionRow);
+        root.setPadding(YGEdgeLeft, offset);
+        for (int i = 0; i < 16; ++i) {
+            TestNode panel = root.createChild(i, "panel");
+            panel.setWidth(panelWidth);
+            panel.setHeight(300.f);
+            panel.setFlexShrink(0.f);
+            if (marginPercent != 0.f) {
+                panel.setMarginPercent(YGEdgeLeft, marginPercent);
+                panel.setMarginPercent(YGEdgeTop, marginPercent);
+            }
+            for (int j = 0; j < 8; ++j) {
+                TestNode row = panel.createChild(j, "row");
+                row.setHeight(rowHeight + static_cast<float>(j));
+            }
+        }
+        TestNode filler = root.createChild(99, "filler");
+        filler.setFlexGrow(1.f);
+        return root;
+    };
+
+    TestLayout serialLayout{config};
+    TestNode serial = build(serialLayout);
+    serial.calculateLayout(1000.f, 300.f);
+
+    TestLayout parallelLayout{config};
+    TestNode parallel = build(parallelLayout);
+    Yoga::ThreadPool pool{4};
+    parallelLayout.calculateLayoutParallel(parallel, 1000.f, 300.f, pool);
+
+    ASSERT_EQ(parallel.getChildCount(), serial.getChildCount());
+    for (size_t i = 0; i < serial.getChildCount(); ++i) {
+        TestNode expected = serial.getChild(i);
+        TestNode actual = parallel.getChild(i);
+        EXPECT_FLOAT_EQ(actual.getLayoutLeft(), expected.getLayoutLeft());
+        EXPECT_FLOAT_EQ(actual.getLayoutTop(), expected.getLayoutTop());
+        EXPECT_FLOAT_EQ(actual.getLayoutWidth(), expected.getLayoutWidth());
+        EXPECT_FLOAT_EQ(actual.getLayoutHeight(), expected.getLayoutHeight());
+        for (size_t j = 0; j < expected.getChildCount(); ++j) {
+            EXPECT_FLOAT_EQ(actual.getChild(j).getLayoutTop(), expected.getChild(j).getLayoutTop());
+            EXPECT_FLOAT_EQ(actual.getChild(j).getLayoutWidth(), expected.getChild(j).getLayoutWidth());
+            EXPECT_FLOAT_EQ(actual.getChild(j).getLayoutHeight(), expected.getChild(j).getLayoutHeight());
+        }
+    }
+    EXPECT_FALSE(parallel.isDirty());
+}
+
+TEST(ParallelLayoutTest, MatchesSerialLayout) {
+    Yoga::Config unrounded;
+    unrounded.setPointScaleFactor(0.f);
+    expectParallelMatchesSerial(unrounded, 0.f, 50.f, 10.f);
+}
+
+TEST(ParallelLayoutTest, MatchesSerialLayoutAtFractionalOffsets) {
+    // Panels start at fractional offsets, where rounding each boundary on its own would shift its contents.
+    Yoga::Config rounded;
+    expectParallelMatchesSerial(rounded, 0.4f, 50.3f, 10.35f);
+
+    Yoga::Config unrounded;
+    unrounded.setPointScaleFactor(0.f);
+    expectParallelMatchesSerial(unrounded, 0.4f, 50.3f, 10.35f);
+}
+
+TEST(ParallelLayoutTest, MatchesSerialLayoutWithPercentMargins) {
+    // Fixed-size panels whose margins resolve against the root's width must not be laid out on their own.
+    Yoga::Config unrounded;
+    unrounded.setPointScaleFactor(0.f);
+    expectParallelMatchesSerial(unrounded, 0.f, 50.f, 10.f, 1.5f);
+}
+
+// Only takes plain function pointers, so it cannot run the lambdas the layout passes.
+struct FunctionPointerExecutor {
+    void parallelFor(size_t count, void (*fn)(size_t)) {
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+    }
+};
+
+struct SerialExecutor {
+    size_t calls = 0;
+
+    template <typename Fn>
+    void parallelFor(size_t count, Fn&& fn) {
+        ++calls;
+        for (size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+    }
+};
+
+static_assert(Yoga::ParallelExecutor<Yoga::ThreadPool>);
+static_assert(Yoga::ParallelExecutor<SerialExecutor>);
+static_assert(!Yoga::ParallelExecutor<FunctionPointerExecutor>);
+
+TEST(ParallelLayoutTest, AcceptsCustomExecutor) {
+    Yoga::Config unrounded;
+    unrounded.setPointScaleFactor(0.f);
+    TestLayout layout{unrounded};
+    TestNode root = layout.createNode(0, "root");
+    root.setFlexDirection(YGFlexDirectionRow);
+    for (int i = 0; i < 4; ++i) {
+        TestNode panel = root.createChild(i, "panel");
+        panel.setWidth(40.f);
+        panel.setHeight(40.f);
+        panel.setFlexShrink(0.f);
+    }
+
+    SerialExecutor executor;
+    layout.calculateLayoutParallel(root, 200.f, 40.f, executor);
+    EXPECT_EQ(executor.calls, 1u);
+    EXPECT_FLOAT_EQ(root.getChild(3).getLayoutLeft(), 120.f);
+    EXPECT_FALSE(root.isDirty());
+}
+
+TEST(CalculateAllTest, LaysOutEveryRoot) {
+    TestLayout layout;
+    std::vector<TestNode> roots;
+    std::vector<YGSize> sizes;
+    for (int i = 0; i < 32; ++i) {
+        TestNode root = layout.createNode(i, "root");
+        TestNode child = root.createChild(100 + i, "child");
+        child.setFlexGrow(1.f);
+        roots.push_back(root);
+        sizes.push_back({static_cast<float>(10 * (i + 1)), 20.f});
+    }
+
+    Yoga::ThreadPool pool{4};
+    std::vector<std::chrono::nanoseconds> timings(roots.size());
+    layout.calculateAll(roots, sizes, pool, timings);
+
+    for (size_t i = 0; i < roots.size(); ++i) {
+        EXPECT_FLOAT_EQ(roots[i].getLayoutWidth(), sizes[i].width);
+        EXPECT_FLOAT_EQ(roots[i].getChild(0).getLayoutHeight(), 20.f);
+        EXPECT_FALSE(roots[i].isDirty());
+        EXPECT_GE(timings[i].count(), 0);
+    }
+}
+
+TEST(ConcurrentLayoutTest, BuildsSubtreesOnWorkerThreads) {
+    Yoga::ConcurrentLayout<TestContext> layout;
+    Yoga::Node<TestContext> root = layout.createNode();
+
+    constexpr int threadCount = 4;
+    constexpr int nodesPerThread = 200;
+    std::vector<Yoga::Node<TestContext>> subtrees(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            Yoga::Node<TestContext> subtree = layout.createNode(t + 1, "subtree");
+            for (int i = 0; i < nodesPerThread; ++i) {
+                Yoga::Node<TestContext> child = subtree.createChild(i, "child");
+                if (i % 2 == 0) {
+                    layout.destroyNode(child);
+                }
+            }
+            subtrees[t] = subtree;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    root.setChildren(subtrees);
+    EXPECT_EQ(layout.size(), 1u + threadCount + threadCount * nodesPerThread / 2);
+    for (int t = 0; t < threadCount; ++t) {
+        EXPECT_EQ(root.getChild(t).getContext().id, t + 1);
+        EXPECT_EQ(root.getChild(t).getChildCount(), static_cast<size_t>(nodesPerThread / 2));
+    }
+
+    // Nodes created on a worker can be destroyed from here.
+    Yoga::Node<TestContext> first = root.getChild(0).getChild(0);
+    layout.destroyNode(first);
+    EXPECT_FALSE(first.valid());
+}
+
+TEST(ConcurrentLayoutTest, CountsNodesWhileWorkersCreateThem) {
+    Yoga::ConcurrentLayout<TestContext> layout;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 100; ++i) {
+                (void)layout.createNode(t, "worker");
+            }
+        });
+    }
+
+    std::thread counter{[&] {
+        while (!done.load()) {
+            EXPECT_LE(layout.size(), 800u);
+            (void)layout.getRecycleStats();
+        }
+    }};
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done = true;
+    counter.join();
+    EXPECT_EQ(layout.size(), 800u);
+}
+
+TEST(ConcurrentLayoutTest, DrainsWhileWorkerDirtiesNodes) {
+    Yoga::ConcurrentLayout<TestContext> layout;
+    layout.setTrackDirtied(true);
+    constexpr int rounds = 2000;
+
+    // Each round cleans the worker's root and then dirties it once by inserting a child.
+    std::atomic<bool> done{false};
+    TestNode root;
+    std::thread worker{[&] {
+        root = layout.createNode(0, "root");
+        for (int i = 0; i < rounds; ++i) {
+            root.calculateLayout(100.f, 100.f);
+            TestNode child = root.createChild(i, "child");
+            layout.destroyNode(child);
+        }
+        done = true;
+    }};
+
+    int drained = 0;
+    auto drain = [&](TestNode node) {
+        if (node == root) {
+            ++drained;
+        }
+    };
+    while (!done.load()) {
+        (void)layout.getDirtied();
+        layout.drainDirtied(drain);
+    }
+    worker.join();
+    layout.drainDirtied(drain);
+    EXPECT_EQ(drained, rounds);
+}
+
+TEST(ConcurrentLayoutTest, ReusesRegistriesOfEndedThreads) {
+    Yoga::ConcurrentLayout<TestContext> layout;
+    layout.setRecycleLimit(4);
+
+    // The first thread leaves a pooled Yoga node behind in its registry.
+    YGNodeRef pooled = nullptr;
+    std::thread{[&] {
+        Yoga::Node<TestContext> node = layout.createNode(1, "first");
+        pooled = node.get();
+        layout.destroyNode(node);
+    }}.join();
+
+    // The next thread takes that registry over instead of starting an empty one.
+    YGNodeRef reused = nullptr;
+    std::thread{[&] { reused = layout.createNode(2, "second").get(); }}.join();
+
+    EXPECT_EQ(reused, pooled);
+    EXPECT_EQ(layout.getRecycleStats().hits, 1u);
+    EXPECT_EQ(layout.size(), 1u);
+}
+
+TEST(DetachedSubtreeTest, AdoptionKeepsHandlesValid) {
+    TestLayout layout;
+    TestNode root = layout.createNode();
+
+    Yoga::DetachedSubtree<TestContext> subtree{layout, 1, "page"};
+    std::vector<TestNode> rows;
+    std::thread builder([&] {
+        for (int i = 0; i < 100; ++i) {
+            rows.push_back(subtree.getRoot().createChild(10 + i, "row"));
+        }
+    });
+    builder.join();
+    EXPECT_EQ(layout.size(), 1u);
+
+    TestNode page = layout.adopt(std::move(subtree), root, 0);
+    EXPECT_TRUE(subtree.adopted());
+    EXPECT_EQ(layout.size(), 102u);
+    EXPECT_EQ(root.getChild(0), page);
+    EXPECT_EQ(page.getContext().name, "page");
+    EXPECT_EQ(page.getChildCount(), 100u);
+
+    // Adopted nodes mix freely with the layout's own.
+    TestNode extra = layout.createNode(500, "extra");
+    rows[0].insertChild(extra);
+    layout.destroyNode(rows[1]);
+    EXPECT_FALSE(rows[1].valid());
+    EXPECT_TRUE(rows[2].valid());
+    EXPECT_EQ(layout.size(), 102u);
+}
+
+TEST(DetachedSubtreeTest, UnadoptedSubtreeFreesItsNodes) {
+    TestLayout layout;
+    {
+        Yoga::DetachedSubtree<TestContext> subtree{layout};
+        subtree.getRoot().createChild(1, "row");
+        EXPECT_EQ(subtree.getLayout().size(), 2u);
+    }
+    EXPECT_EQ(layout.size(), 0u);
+}
+
+TEST(ChildRangeTest, ModelsSizedRandomAccessRange) {
+    using Range = decltype(std::declval<TestNode&>().getChildren());
+    static_assert(std::ranges::random_access_range<Range>);
+    static_assert(std::ranges::sized_range<Range>);
+    static_assert(std::ranges::view<Range>);
+
+    TestLayout layout;
+    TestNode parent = layout.createNode();
+    for (int i = 0; i < 5; ++i) {
+        parent.createChild(i, "child");
+    }
+
+    auto children = parent.getChildren();
+    EXPECT_EQ(children.size(), 5u);
+    EXPECT_EQ(children[3], parent.getChild(3));
+    EXPECT_EQ(children.begin()->getContext().id, 0);
+    EXPECT_EQ((children.end() - 1)->getContext().id, 4);
+
+    auto odd = children | std::views::filter([](TestNode child) { return child.getContext().id % 2 == 1; });
+    EXPECT_EQ(std::ranges::distance(odd), 2);
+
+    TestNode empty;
+    EXPECT_TRUE(Yoga::ChildRange<TestNode>{empty}.empty());
+}
+
+TEST(NodeRecyclingTest, ReusesDestroyedNodesUpToLimit) {
+    TestLayout layout;
+    layout.setRecycleLimit(2);
+    TestNode root = layout.createNode();
+
+    std::vector<TestNode> rows;
+    for (int i = 0; i < 3; ++i) {
+        TestNode row = root.createChild(i, "row");
+        row.setWidth(50.f);
+        row.createChild(100 + i, "label");
+        rows.push_back(row);
+    }
+    // The pool is last in, first out; the third row overflows it.
+    const YGNodeRef lastPooled = rows[1].get();
+    for (auto& row : rows) {
+        layout.destroyNode(row);
+    }
+
+    auto stats = layout.getRecycleStats();
+    EXPECT_EQ(stats.pooled, 2u);
+    EXPECT_EQ(root.getChildCount(), 0u);
+
+    // Recycled nodes come back detached and with default style.
+    TestNode reused = layout.createNode(7, "reused");
+    EXPECT_EQ(reused.get(), lastPooled);
+    EXPECT_EQ(reused.getContext().id, 7);
+    EXPECT_EQ(reused.getChildCount(), 0u);
+    EXPECT_FALSE(reused.getParent().valid());
+    EXPECT_EQ(reused.getWidth().unit, YGUnitAuto);
+
+    stats = layout.getRecycleStats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.pooled, 1u);
+
+    layout.setRecycleLimit(0);
+    EXPECT_EQ(layout.getRecycleStats().pooled, 0u);
+}
+
+TEST(NodeRecyclingTest, DestroyingChildDirtiesParentAtAnyRecycleLimit) {
+    for (const size_t limit : {size_t{0}, size_t{4}}) {
+        TestLayout layout;
+        layout.setRecycleLimit(limit);
+        layout.setTrackDirtied(true);
+        TestNode root = layout.createNode(0, "root");
+        TestNode child = root.createChild(1, "child");
+        root.calculateLayout(100.f, 100.f);
+        layout.clearDirtied();
+        ASSERT_FALSE(root.isDirty());
+
+        layout.destroyNode(child);
+        EXPECT_TRUE(root.isDirty()) << "recycle limit " << limit;
+        EXPECT_EQ(root.getChildCount(), 0u);
+        ASSERT_EQ(layout.getDirtied().size(), 1u) << "recycle limit " << limit;
+        EXPECT_EQ(layout.getDirtied()[0], root);
+    }
+}
+
+TEST(NodeRecyclingTest, StaleHandleDiffersFromNodeReusingItsYogaNode) {
+    TestLayout layout;
+    layout.setRecycleLimit(4);
+
+    TestNode first = layout.createNode(1, "first");
+    const TestNode stale = first;
+    layout.destroyNode(first);
+    TestNode second = layout.createNode(2, "second");
+
+    ASSERT_EQ(second.get(), stale.get());
+    EXPECT_FALSE(stale.valid());
+    EXPECT_NE(stale, second);
+}
+
+TEST(DestroySubtreeTest, DestroysBranchAndKeepsSiblings) {
+    TestLayout layout;
+    layout.setTrackDirtied(true);
+    TestNode root = layout.createNode();
+    TestNode before = root.createChild(1, "before");
+    TestNode panel = root.createChild(2, "panel");
+    TestNode after = root.createChild(3, "after");
+
+    std::vector<TestNode> descendants;
+    for (int i = 0; i < 10; ++i) {
+        TestNode section = panel.createChild(10 + i, "section");
+        descendants.push_back(section);
+        for (int j = 0; j < 10; ++j) {
+            descendants.push_back(section.createChild(100 + j, "cell"));
+        }
+    }
+    root.calculateLayout(100.f, 100.f);
+    layout.clearDirtied();
+
+    EXPECT_EQ(layout.destroySubtree(panel), 111u);
+    EXPECT_FALSE(panel.valid());
+    for (const auto& node : descendants) {
+        EXPECT_FALSE(node.valid());
+    }
+    EXPECT_EQ(layout.size(), 3u);
+    ASSERT_EQ(root.getChildCount(), 2u);
+    EXPECT_EQ(root.getChild(0), before);
+    EXPECT_EQ(root.getChild(1), after);
+
+    // Only the surviving parent reports being dirtied.
+    ASSERT_EQ(layout.getDirtied().size(), 1u);
+    EXPECT_EQ(layout.getDirtied()[0], root);
+}
+
+TEST(DestroySubtreeTest, FeedsRecyclingPool) {
+    TestLayout layout;
+    layout.setRecycleLimit(100);
+    TestNode root = layout.createNode();
+    for (int i = 0; i < 4; ++i) {
+        root.createChild(i, "child").createChild(i, "grandchild");
+    }
+
+    EXPECT_EQ(layout.destroySubtree(root), 9u);
+    EXPECT_EQ(layout.getRecycleStats().pooled, 9u);
+    EXPECT_EQ(layout.size(), 0u);
+}
+
+TEST(LayoutClearTest, ReusesNodesAcrossFrames) {
+    TestLayout layout;
+    std::vector<TestNode> previous;
+
+    for (int frame = 0; frame < 3; ++frame) {
+        TestNode root = layout.createNode(frame, "overlay");
+        for (int i = 0; i < 20; ++i) {
+            root.createChild(i, "item").setHeight(10.f);
+        }
+        root.calculateLayout(100.f, YGUndefined);
+        EXPECT_EQ(layout.size(), 21u);
+        EXPECT_FLOAT_EQ(root.getChild(19).getLayoutTop(), 190.f);
+
+        for (const auto& node : previous) {
+            EXPECT_FALSE(node.valid());
+        }
+        previous.assign(root.getChildren().begin(), root.getChildren().end());
+
+        layout.clear();
+        EXPECT_EQ(layout.size(), 0u);
+        EXPECT_EQ(layout.getRecycleStats().pooled, 21u);
+    }
+
+    // Every frame after the first was built entirely from kept nodes.
+    EXPECT_EQ(layout.getRecycleStats().hits, 42u);
+    EXPECT_EQ(layout.getRecycleStats().misses, 0u);
+
+    layout.clear(Yoga::KeepCapacity::No);
+    EXPECT_EQ(layout.getRecycleStats().pooled, 0u);
+}
+
+TEST(LayoutClearTest, ReusesAdoptedNodesWithoutDirtiedCallbacks) {
+    TestLayout layout;
+    layout.setTrackDirtied(true);
+
+    // The root is created last, so clear() detaches its children before reaching it.
+    Yoga::DetachedSubtree<TestContext> subtree{layout, 1, "panel"};
+    for (int i = 0; i < 8; ++i) {
+        subtree.getRoot().createChild(i, "row");
+    }
+    TestNode panel = layout.adopt(std::move(subtree));
+    TestNode root = layout.createNode(0, "root");
+    root.insertChild(panel);
+    root.calculateLayout(100.f, 100.f);
+    layout.clearDirtied();
+
+    DirtiedCounter::calls = 0;
+    root.setDirtiedFunc(DirtiedCounter{});
+    layout.clear();
+    EXPECT_EQ(DirtiedCounter::calls, 0);
+    EXPECT_TRUE(layout.getDirtied().empty());
+
+    // Nodes built in the adopted subtree are handed out by createNode on this thread.
+    EXPECT_EQ(layout.getRecycleStats().pooled, 10u);
+    for (int i = 0; i < 10; ++i) {
+        (void)layout.createNode(i, "reused");
+    }
+    EXPECT_EQ(layout.getRecycleStats().hits, 10u);
+    EXPECT_EQ(layout.getRecycleStats().pooled, 0u);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "yoga-cpp/snapshot.hpp"
+
+using SnapshotLayout = Yoga::Layout<int>;
+using SnapshotNode = Yoga::Node<int>;
+
+class LayoutSnapshotTest : public testing::Test {
+protected:
+    SnapshotLayout layout;
+    SnapshotNode root;
+    SnapshotNode sidebar;
+    SnapshotNode content;
+    SnapshotNode header;
+    SnapshotNode body;
+
+    void SetUp() override {
+        root = layout.createNode(0);
+        root.setFlexDirection(YGFlexDirectionRow);
+        root.setWidth(400.f);
+        root.setHeight(100.f);
+
+        sidebar = root.createChild(1);
+        sidebar.setWidth(100.f);
+
+        content = root.createChild(2);
+        content.setFlexGrow(1.f);
+
+        header = content.createChild(3);
+        header.setHeight(30.f);
+
+        body = content.createChild(4);
+        body.setHeight(20.f);
+        body.setPadding(YGEdgeLeft, 5.f);
+
+        root.calculateLayout(400.f, 100.f);
+    }
+};
+
+TEST_F(LayoutSnapshotTest, CapturesAbsoluteBoundsInPreOrder) {
+    Yoga::LayoutSnapshot<int> snapshot;
+    snapshot.capture(root);
+
+    ASSERT_EQ(snapshot.size(), 5u);
+    EXPECT_EQ(snapshot.nodes()[0], root);
+    EXPECT_EQ(snapshot.nodes()[1], sidebar);
+    EXPECT_EQ(snapshot.nodes()[2], content);
+    EXPECT_EQ(snapshot.nodes()[3], header);
+    EXPECT_EQ(snapshot.nodes()[4], body);
+
+    EXPECT_EQ(snapshot.parents()[0], Yoga::LayoutSnapshot<int>::npos);
+    EXPECT_EQ(snapshot.parents()[4], 2u);
+
+    EXPECT_FLOAT_EQ(snapshot.x()[4], 100.f);
+    EXPECT_FLOAT_EQ(snapshot.y()[4], 30.f);
+    EXPECT_FLOAT_EQ(snapshot.width()[4], 300.f);
+    EXPECT_FLOAT_EQ(snapshot.height()[4], 20.f);
+
+    EXPECT_TRUE(snapshot.padding()[0].empty());
+}
+
+TEST_F(LayoutSnapshotTest, OptionalEdgesAndHiddenNodes) {
+    sidebar.setDisplay(YGDisplayNone);
+    root.calculateLayout(400.f, 100.f);
+
+    Yoga::LayoutSnapshot<int> snapshot;
+    snapshot.capture(root, {.padding = true});
+
+    ASSERT_EQ(snapshot.size(), 4u);
+    EXPECT_EQ(snapshot.nodes()[1], content);
+    ASSERT_EQ(snapshot.padding()[YGEdgeLeft].size(), 4u);
+    EXPECT_FLOAT_EQ(snapshot.padding()[YGEdgeLeft][3], 5.f);
+    EXPECT_TRUE(snapshot.margin()[YGEdgeLeft].empty());
+
+    snapshot.capture(root, {.skipHidden = false});
+    EXPECT_EQ(snapshot.size(), 5u);
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "yoga-cpp/spatial_index.hpp"
+
+using GridLayout = Yoga::Layout<int>;
+using GridNode = Yoga::Node<int>;
+
+namespace {
+    GridNode absoluteChild(GridNode parent, int id, float left, float top, float width, float height)
+    {
+        GridNode child = parent.createChild(id);
+        child.setPositionType(YGPositionTypeAbsolute);
+        child.setPosition(YGEdgeLeft, left);
+        child.setPosition(YGEdgeTop, top);
+        child.setWidth(width);
+        child.setHeight(height);
+        return child;
+    }
+
+    std::vector<int> ids(const std::vector<GridNode>& nodes)
+    {
+        std::vector<int> result;
+        for (const auto& node : nodes) {
+            result.push_back(node.getContext());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+}
+
+TEST(SpatialIndexTest, QueriesRegionsAndPoints) {
+    GridLayout layout;
+    GridNode root = layout.createNode(0);
+    root.setWidth(400.f);
+    root.setHeight(400.f);
+    GridNode panel = absoluteChild(root, 1, 100.f, 100.f, 200.f, 200.f);
+    absoluteChild(panel, 2, 10.f, 10.f, 20.f, 20.f);
+    absoluteChild(root, 3, 350.f, 0.f, 50.f, 50.f);
+    root.calculateLayout(400.f, 400.f);
+
+    Yoga::SpatialIndex<int> index{32.f};
+    index.update(root);
+    EXPECT_EQ(index.size(), 4u);
+
+    std::vector<GridNode> found;
+    index.query(101.f, 101.f, 5.f, 5.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0, 1}));
+
+    found.clear();
+    index.query(0.f, 0.f, 400.f, 400.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0, 1, 2, 3}));
+
+    found.clear();
+    index.queryPoint(115.f, 115.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0, 1, 2}));
+
+    found.clear();
+    index.queryPoint(500.f, 500.f, std::back_inserter(found));
+    EXPECT_TRUE(found.empty());
+}
+
+TEST(SpatialIndexTest, UpdateFollowsMovedSubtrees) {
+    GridLayout layout;
+    GridNode root = layout.createNode(0);
+    root.setWidth(400.f);
+    root.setHeight(400.f);
+    GridNode panel = absoluteChild(root, 1, 0.f, 0.f, 100.f, 100.f);
+    absoluteChild(panel, 2, 10.f, 10.f, 20.f, 20.f);
+    root.calculateLayout(400.f, 400.f);
+
+    Yoga::SpatialIndex<int> index{50.f};
+    index.update(root);
+    EXPECT_FALSE(panel.hasNewLayout());
+
+    panel.setPosition(YGEdgeLeft, 250.f);
+    root.calculateLayout(400.f, 400.f);
+    index.update(root);
+
+    std::vector<GridNode> found;
+    index.queryPoint(15.f, 15.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0}));
+
+    found.clear();
+    index.queryPoint(265.f, 15.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(SpatialIndexTest, RemoveAndPrune) {
+    GridLayout layout;
+    GridNode root = layout.createNode(0);
+    root.setWidth(100.f);
+    root.setHeight(100.f);
+    GridNode first = absoluteChild(root, 1, 0.f, 0.f, 50.f, 50.f);
+    GridNode second = absoluteChild(root, 2, 0.f, 0.f, 50.f, 50.f);
+    root.calculateLayout(100.f, 100.f);
+
+    Yoga::SpatialIndex<int> index;
+    index.update(root);
+    EXPECT_EQ(index.size(), 3u);
+
+    index.remove(first);
+    layout.destroyNode(second);
+
+    std::vector<GridNode> found;
+    index.queryPoint(10.f, 10.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0}));
+
+    index.prune();
+    EXPECT_EQ(index.size(), 1u);
+
+    index.rebuild(root);
+    EXPECT_EQ(index.size(), 2u);
+}
+
+TEST(SpatialIndexTest, HugeNodesAndQueriesStayCheap) {
+    GridLayout layout;
+    GridNode root = layout.createNode(0);
+    root.setWidth(400.f);
+    root.setHeight(400.f);
+    // A scrolling list far taller than the viewport, holding one row near its end.
+    GridNode list = absoluteChild(root, 1, 0.f, 0.f, 400.f, 1000000.f);
+    absoluteChild(list, 2, 0.f, 999000.f, 400.f, 40.f);
+    absoluteChild(root, 3, 10.f, 10.f, 20.f, 20.f);
+    root.calculateLayout(400.f, 400.f);
+
+    Yoga::SpatialIndex<int> index{64.f};
+    index.update(root);
+    EXPECT_EQ(index.size(), 4u);
+
+    std::vector<GridNode> found;
+    index.queryPoint(15.f, 999010.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{1, 2}));
+
+    found.clear();
+    index.query(-1e9f, -1e9f, 2e9f, 2e9f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0, 1, 2, 3}));
+
+    constexpr float inf = std::numeric_limits<float>::infinity();
+    found.clear();
+    index.query(0.f, 0.f, inf, inf, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0, 1, 2, 3}));
+
+    found.clear();
+    index.queryPoint(std::numeric_limits<float>::quiet_NaN(), 15.f, std::back_inserter(found));
+    EXPECT_TRUE(found.empty());
+}
+
+TEST(SpatialIndexTest, StaleHandleDoesNotRemoveRecycledNode) {
+    GridLayout layout;
+    layout.setRecycleLimit(4);
+    GridNode root = layout.createNode(0);
+    root.setWidth(100.f);
+    root.setHeight(100.f);
+    GridNode first = absoluteChild(root, 1, 0.f, 0.f, 50.f, 50.f);
+    const GridNode stale = first;
+    root.calculateLayout(100.f, 100.f);
+
+    Yoga::SpatialIndex<int> index;
+    index.update(root);
+
+    // The replacement reuses the destroyed node's Yoga node.
+    layout.destroyNode(first);
+    GridNode second = absoluteChild(root, 2, 0.f, 0.f, 50.f, 50.f);
+    ASSERT_EQ(second.get(), stale.get());
+    root.calculateLayout(100.f, 100.f);
+    index.update(root);
+
+    index.remove(stale);
+    std::vector<GridNode> found;
+    index.queryPoint(10.f, 10.f, std::back_inserter(found));
+    EXPECT_EQ(ids(found), (std::vector<int>{0, 2}));
+}
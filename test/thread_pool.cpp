@@ -0,0 +1,54 @@
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "yoga-cpp/thread_pool.hpp"
+
+TEST(ThreadPoolTest, VisitsEveryIndexOnce) {
+    Yoga::ThreadPool pool{4};
+    EXPECT_EQ(pool.size(), 4u);
+
+    std::vector<std::atomic<int>> visits(1000);
+    for (int round = 0; round < 3; ++round) {
+        pool.parallelFor(visits.size(), [&](size_t i) { visits[i].fetch_add(1); });
+    }
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 3);
+    }
+}
+
+TEST(ThreadPoolTest, NestedLoopsRunInline) {
+    Yoga::ThreadPool pool{3};
+    std::atomic<int> total{0};
+    pool.parallelFor(8, [&](size_t) {
+        pool.parallelFor(8, [&](size_t) { total.fetch_add(1); });
+    });
+    EXPECT_EQ(total.load(), 64);
+}
+
+TEST(ThreadPoolTest, RethrowsAfterEveryCallReturns) {
+    Yoga::ThreadPool pool{4};
+    std::atomic<int> running{0};
+
+    // Every index throws, so the calling thread and the workers all fail at once.
+    EXPECT_THROW(pool.parallelFor(1000,
+                                  [&](size_t) {
+                                      running.fetch_add(1);
+                                      std::this_thread::sleep_for(std::chrono::microseconds{50});
+                                      running.fetch_sub(1);
+                                      throw std::runtime_error{"failed"};
+                                  }),
+                 std::runtime_error);
+    // Nothing is still running once the exception reaches the caller.
+    EXPECT_EQ(running.load(), 0);
+
+    // The pool stays usable, including nested loops on the calling thread.
+    std::atomic<int> total{0};
+    pool.parallelFor(8, [&](size_t) {
+        pool.parallelFor(8, [&](size_t) { total.fetch_add(1); });
+    });
+    EXPECT_EQ(total.load(), 64);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "yoga-cpp/traversal.hpp"
+
+using WalkLayout = Yoga::Layout<int>;
+using WalkNode = Yoga::Node<int>;
+
+namespace {
+    /*
+     *        0
+     *      /   \
+     *     1     4
+     *    / \     \
+     *   2   3     5
+     */
+    WalkNode buildTree(WalkLayout& layout)
+    {
+        WalkNode root = layout.createNode(0);
+        WalkNode left = root.createChild(1);
+        left.createChild(2);
+        left.createChild(3);
+        root.createChild(4).createChild(5);
+        return root;
+    }
+
+    template <typename View>
+    std::vector<std::pair<int, uint32_t>> collect(View&& view)
+    {
+        std::vector<std::pair<int, uint32_t>> visits;
+        for (auto [node, depth] : view) {
+            visits.emplace_back(node.getContext(), depth);
+        }
+        return visits;
+    }
+}
+
+TEST(TraversalTest, VisitsInEachOrderWithDepth) {
+    static_assert(std::ranges::input_range<decltype(Yoga::views::preorder(std::declval<WalkNode&>()))>);
+    static_assert(std::ranges::view<decltype(Yoga::views::postorder(std::declval<WalkNode&>()))>);
+
+    WalkLayout layout;
+    WalkNode root = buildTree(layout);
+
+    using Visits = std::vector<std::pair<int, uint32_t>>;
+    EXPECT_EQ(collect(Yoga::views::preorder(root)), (Visits{{0, 0}, {1, 1}, {2, 2}, {3, 2}, {4, 1}, {5, 2}}));
+    EXPECT_EQ(collect(Yoga::views::postorder(root)), (Visits{{2, 2}, {3, 2}, {1, 1}, {5, 2}, {4, 1}, {0, 0}}));
+    EXPECT_EQ(collect(Yoga::views::breadth_first(root)), (Visits{{0, 0}, {1, 1}, {4, 1}, {2, 2}, {3, 2}, {5, 2}}));
+}
+
+TEST(TraversalTest, SkipsHiddenSubtrees) {
+    WalkLayout layout;
+    WalkNode root = buildTree(layout);
+    root.getChild(0).setDisplay(YGDisplayNone);
+
+    const Yoga::views::TraversalOptions options{.skipHidden = true};
+    using Visits = std::vector<std::pair<int, uint32_t>>;
+    EXPECT_EQ(collect(Yoga::views::preorder(root, options)), (Visits{{0, 0}, {4, 1}, {5, 2}}));
+    EXPECT_EQ(collect(Yoga::views::postorder(root, options)), (Visits{{5, 2}, {4, 1}, {0, 0}}));
+    EXPECT_EQ(collect(Yoga::views::breadth_first(root, options)), (Visits{{0, 0}, {4, 1}, {5, 2}}));
+    EXPECT_EQ(collect(Yoga::views::preorder(root)).size(), 6u);
+}
+
+TEST(TraversalTest, WalksDeepTreesWithReusedBuffer) {
+    WalkLayout layout;
+    WalkNode root = layout.createNode(0);
+    WalkNode parent = root;
+    for (int i = 1; i < 20000; ++i) {
+        parent = parent.createChild(i);
+    }
+
+    Yoga::views::TraversalBuffer<WalkNode> buffer;
+    uint32_t deepest = 0;
+    for (auto visit : Yoga::views::postorder(root, buffer)) {
+        deepest = std::max(deepest, visit.depth);
+    }
+    EXPECT_EQ(deepest, 19999u);
+
+    const auto capacity = buffer.capacity();
+    size_t visited = 0;
+    for (auto visit : Yoga::views::preorder(root, buffer)) {
+        visited += visit.node.valid() ? 1 : 0;
+    }
+    EXPECT_EQ(visited, 20000u);
+    EXPECT_EQ(buffer.capacity(), capacity);
+}